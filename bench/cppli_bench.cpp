@@ -0,0 +1,623 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "cppli_bench.hpp"
+#include <array>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+
+namespace cli = cppli;
+
+namespace {
+
+    struct lookup_schema {
+        std::unique_ptr<bool[]> flags;
+        std::vector<std::optional<int>> values;
+        cli::parameters parameters;
+        std::vector<std::string> tokens;
+    };
+
+    lookup_schema create_lookup_schema(size_t p_count, size_t p_aliases) {
+        auto schema = lookup_schema{};
+        schema.flags = std::make_unique<bool[]>(p_count);
+        schema.values = std::vector<std::optional<int>>(p_count);
+
+        for (size_t i = 0; i < p_count; i++) {
+            auto names = [&](const std::string& p_prefix) {
+                auto result = std::vector<std::string>{};
+                for (size_t alias = 0; alias < p_aliases; alias++) {
+                    result.push_back(p_prefix + std::to_string(i) + "-" + std::to_string(alias));
+                }
+                return result;
+            };
+
+            schema.parameters.add_option(cli::option_flag<bool>{ schema.flags[i], names("--flag-") });
+            schema.parameters.add_option(cli::option<std::optional<int>>{ schema.values[i], names("--value-") });
+            schema.parameters.add_command(cli::command{ names("command-") });
+
+            schema.tokens.push_back("command-" + std::to_string(i) + "-" + std::to_string(p_aliases - 1));
+        }
+
+        return schema;
+    }
+
+    void run_lookup_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t count : { size_t{ 10 }, size_t{ 100 }, size_t{ 500 }, size_t{ 2000 } }) {
+        for (const size_t aliases : { size_t{ 1 }, size_t{ 3 } }) {
+            const auto schema = create_lookup_schema(count, aliases);
+            const auto& params = schema.parameters;
+            const auto& tokens = schema.tokens;
+            const auto suffix = "/" + std::to_string(count) + "x" + std::to_string(aliases);
+
+            // Every command token is first tested against all flags and optional options, as in parse.
+            p_reporter.add(bench::measure("lookup_scan" + suffix, [&]() {
+                for (const auto& token : tokens) {
+                    bench::do_not_optimize(cli::impl::find_by_name(params.flag_options, token));
+                    bench::do_not_optimize(cli::impl::find_by_name(params.optional_options, token));
+                    bench::do_not_optimize(cli::impl::find_by_name(params.commands, token));
+                }
+            }));
+
+            p_reporter.add(bench::measure("lookup_index" + suffix, [&]() {
+                for (const auto& token : tokens) {
+                    bench::do_not_optimize(params.find_flag(token));
+                    bench::do_not_optimize(params.find_optional(token));
+                    bench::do_not_optimize(params.find_command(token));
+                }
+            }));
+
+            const auto compiled = params.compile();
+            auto parse_tokens = [&](const auto& p_parameters) {
+                for (const auto& token : tokens) {
+                    auto args = std::array{ "program", token.c_str() };
+                    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+                    bench::do_not_optimize(p_parameters.parse(context));
+                }
+            };
+
+            p_reporter.add(bench::measure("parse_parameters" + suffix, [&]() { parse_tokens(params); }));
+            p_reporter.add(bench::measure("parse_compiled" + suffix, [&]() { parse_tokens(compiled); }));
+        }
+        }
+    }
+
+    void run_nesting_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t depth : { size_t{ 1 }, size_t{ 4 }, size_t{ 16 } }) {
+            auto levels = std::vector<cli::parameters>(depth);
+            for (size_t level = 0; level < depth; level++) {
+                auto& current = levels[level];
+                current.add_command(cli::command{ { "other" } });
+                if (level + 1 < depth) {
+                    auto* next = &levels[level + 1];
+                    current.add_command(cli::command{ { "nested" }, "", [next](cli::context& p_context) {
+                        return next->parse(p_context);
+                    } });
+                }
+                else {
+                    current.add_command(cli::command{ { "nested" } });
+                }
+            }
+
+            auto args = std::vector<const char*>{ "path/to/program" };
+            args.insert(args.end(), depth, "nested");
+
+            p_reporter.add(bench::measure("parse_nested/" + std::to_string(depth), [&]() {
+                auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+                bench::do_not_optimize(levels.front().parse(context));
+            }));
+        }
+    }
+
+    void run_composition_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t count : { size_t{ 100 }, size_t{ 1000 } }) {
+            auto names = std::vector<std::string>{};
+            for (size_t i = 0; i < count; i++) {
+                names.push_back("command-" + std::to_string(i));
+            }
+            const auto suffix = "/" + std::to_string(count);
+
+            // Const chaining copies the left hand side for every operator|.
+            p_reporter.add(bench::measure("compose_const_chain" + suffix, [&]() {
+                auto params = cli::parameters{};
+                for (const auto& name : names) {
+                    const auto& previous = params;
+                    params = previous | cli::command{ { name } };
+                }
+                bench::do_not_optimize(params);
+            }));
+
+            p_reporter.add(bench::measure("compose_builder" + suffix, [&]() {
+                auto builder = cli::parameters_builder{};
+                builder.reserve(0, 0, 0, names.size());
+                for (const auto& name : names) {
+                    builder.add_command(cli::command{ { name } });
+                }
+                bench::do_not_optimize(builder.build());
+            }));
+        }
+    }
+
+    void run_abbreviation_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t count : { size_t{ 100 }, size_t{ 2000 } }) {
+            auto schema = create_lookup_schema(count, 1);
+            schema.parameters.set_abbreviations();
+            const auto& params = schema.parameters;
+
+            // Drops the alias digit, which leaves a unique prefix of every command.
+            auto tokens = std::vector<std::string>{};
+            for (const auto& token : schema.tokens) {
+                tokens.push_back(token.substr(0, token.size() - 1));
+            }
+
+            const cli::command* matched_command = nullptr;
+            const auto schema_view = cli::impl::parameters_schema{ params, matched_command };
+            auto result = bench::measure("abbreviation_expand/" + std::to_string(count), [&]() {
+                for (const auto& token : tokens) {
+                    auto ambiguous = false;
+                    bench::do_not_optimize(schema_view.expand_abbreviation(token, ambiguous));
+                }
+            });
+            result.items_per_iteration = tokens.size();
+            p_reporter.add(std::move(result));
+        }
+    }
+
+    void run_suggestion_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t count : { size_t{ 1000 }, size_t{ 10000 } }) {
+            const auto schema = create_lookup_schema(count, 1);
+            const cli::command* matched_command = nullptr;
+            const auto schema_view = cli::impl::parameters_schema{ schema.parameters, matched_command };
+            const auto token = std::string{ "comand-" } + std::to_string(count / 2) + "-0";
+
+            p_reporter.add(bench::measure("suggest/" + std::to_string(count) + "x3_names", [&]() {
+                auto names = std::array<std::string_view, cli::parse_error::max_suggestions>{};
+                bench::do_not_optimize(cli::impl::suggest_schema_names<cli::impl::parameters_schema>(&schema_view, token, names.data(), names.size()));
+                bench::do_not_optimize(names);
+            }));
+        }
+    }
+
+    void run_help_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t count : { size_t{ 10 }, size_t{ 100 }, size_t{ 1000 } }) {
+            const auto schema = create_lookup_schema(count, 2);
+            const auto& params = schema.parameters;
+            const auto context = cli::context{ 0, nullptr, true, {}, cli::default_help{}, { "program" } };
+            const auto suffix = "/" + std::to_string(count);
+
+            p_reporter.add(bench::measure("help_render" + suffix, [&]() {
+                const auto cache = cli::impl::help_cache{};
+                bench::do_not_optimize(cache.get(params, cli::impl::get_help_handler(context, params)));
+            }));
+
+            p_reporter.add(bench::measure("help_cached" + suffix, [&]() {
+                bench::do_not_optimize(cli::default_help::default_string(context, params));
+            }));
+        }
+    }
+
+    void run_completion_benchmarks(bench::reporter& p_reporter) {
+        for (const size_t depth : { size_t{ 4 }, size_t{ 16 } }) {
+            auto child = std::shared_ptr<const cli::parameters>{};
+            for (size_t level = 0; level < depth; level++) {
+                auto builder = cli::parameters_builder{}.reserve(0, 0, 0, 33);
+                for (size_t i = 0; i < 32; i++) {
+                    builder.add_command(cli::command{ { "command-" + std::to_string(i) } });
+                }
+                auto nested = cli::command{ { "nested" } };
+                if (child) {
+                    nested.set_child_parameters(child);
+                }
+                builder.add_command(std::move(nested));
+                child = std::make_shared<const cli::parameters>(builder.set_help(cli::default_help{}).build());
+            }
+
+            auto params = *child;
+            params.set_completion(cli::completion{});
+
+            auto words = std::vector<std::string_view>(depth, "nested");
+            words.back() = "command-1";
+            auto candidates = std::vector<std::string_view>{};
+            const auto suffix = "/" + std::to_string(depth);
+
+            p_reporter.add(bench::measure("complete_candidates" + suffix, [&]() {
+                candidates.clear();
+                bench::do_not_optimize(cli::completion::candidates(params, words.data(), words.size(), candidates));
+            }));
+
+            // The whole __complete round trip inside the process, printing to /dev/null.
+            auto* null_file = std::fopen("/dev/null", "w");
+            auto args = std::vector<const char*>{ "path/to/program", "__complete" };
+            for (const auto word : words) {
+                args.push_back(word.data());
+            }
+
+            p_reporter.add(bench::measure("complete_parse" + suffix, [&]() {
+                auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+                context.output_fd = null_file != nullptr ? fileno(null_file) : 1;
+                bench::do_not_optimize(params.parse(context));
+            }));
+
+            if (null_file != nullptr) {
+                std::fclose(null_file);
+            }
+        }
+    }
+
+    void run_getopt_benchmarks(bench::reporter& p_reporter) {
+        auto flags = std::array<bool, 8>{};
+        auto output = std::optional<std::string_view>{};
+        auto params = cli::parameters{};
+        for (size_t i = 0; i < flags.size(); i++) {
+            params.add_option(cli::option_flag<bool>{ flags[i], { std::string{ '-', static_cast<char>('a' + i) } } });
+        }
+        params.add_option(cli::option<std::optional<std::string_view>>{ output, { "-o", "--output" } });
+
+        auto context = cli::context{};
+        auto parse = [&](auto& p_args) {
+            context.set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()));
+            context.current_path.clear();
+            bench::do_not_optimize(params.parse(context));
+        };
+
+        auto separate_args = std::array{ "path/to/program", "-a", "-b", "-c", "-d", "-e", "-f", "-g", "-h", "--output", "file" };
+        p_reporter.add(bench::measure("getopt_separate/8_flags", [&]() { parse(separate_args); }));
+
+        auto clustered_args = std::array{ "path/to/program", "-abcdefgh", "--output=file" };
+        p_reporter.add(bench::measure("getopt_clustered/8_flags", [&]() { parse(clustered_args); }));
+
+        auto attached_args = std::array{ "path/to/program", "-abcdefghofile" };
+        p_reporter.add(bench::measure("getopt_attached/8_flags", [&]() { parse(attached_args); }));
+    }
+
+    void run_rest_arguments_benchmarks(bench::reporter& p_reporter) {
+        auto jobs = std::optional<int>{};
+        auto files = cli::argument_span{};
+        const auto params = cli::parameters{}
+            | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }
+            | cli::rest_arguments{ files, "files" };
+
+        auto storage = std::vector<std::string>{};
+        for (size_t i = 0; i < 200000; i++) {
+            storage.push_back("file" + std::to_string(i));
+        }
+        auto args = std::vector<char*>{};
+        for (const auto* arg : { "path/to/program", "--jobs", "8", "--" }) {
+            args.push_back(const_cast<char*>(arg));
+        }
+        for (auto& file : storage) {
+            args.push_back(file.data());
+        }
+
+        auto context = cli::context{};
+        p_reporter.add(bench::measure("rest_arguments/200k_files", [&]() {
+            context.set_arg(static_cast<int>(args.size()), args.data());
+            context.current_path.clear();
+            bench::do_not_optimize(params.parse(context));
+            bench::do_not_optimize(files.size());
+        }));
+    }
+
+    void run_environment_benchmarks(bench::reporter& p_reporter) {
+        constexpr size_t option_count = 16;
+        auto values = std::vector<std::optional<int>>(option_count);
+        auto variables = std::vector<std::string>{};
+        auto storage = std::vector<std::string>{};
+        for (size_t i = 0; i < 64; i++) {
+            storage.push_back("BENCH_OTHER_" + std::to_string(i) + "=value");
+        }
+        auto params = cli::parameters{};
+        for (size_t i = 0; i < option_count; i++) {
+            variables.push_back("BENCH_OPTION_" + std::to_string(i));
+            storage.push_back(variables.back() + "=" + std::to_string(i));
+            params.add_option(cli::option<std::optional<int>>{ values[i], { "--option-" + std::to_string(i) } }.set_environment(variables.back()));
+        }
+        auto environment = std::vector<char*>{};
+        for (auto& variable : storage) {
+            environment.push_back(variable.data());
+        }
+        environment.push_back(nullptr);
+
+        auto args = std::array<const char*, 1>{ "path/to/program" };
+        auto context = cli::context{};
+
+        p_reporter.add(bench::measure("environment_parse/16_options", [&]() {
+            context.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data())).set_environment(environment.data());
+            context.current_path.clear();
+            bench::do_not_optimize(params.parse(context));
+        }));
+
+        // Baseline of one linear scan per option, as getenv does.
+        p_reporter.add(bench::measure("environment_linear_scan/16_options", [&]() {
+            for (const auto& variable : variables) {
+                for (auto** entry = environment.data(); *entry != nullptr; ++entry) {
+                    const auto current = std::string_view{ *entry };
+                    if (current.size() > variable.size() && current.compare(0, variable.size(), variable) == 0 && current[variable.size()] == '=') {
+                        bench::do_not_optimize(current);
+                        break;
+                    }
+                }
+            }
+        }));
+    }
+
+    void run_conversion_benchmarks(bench::reporter& p_reporter) {
+        const auto int_tokens = std::array<std::string_view, 4>{ "0", "42", "-1234567", "2147483647" };
+        const auto double_tokens = std::array<std::string_view, 4>{ "0.5", "3.14159", "-2e10", "1e-300" };
+        const auto bool_tokens = std::array<std::string_view, 4>{ "true", "FALSE", "1", "0" };
+        const auto string_tokens = std::array<std::string_view, 4>{ "a", "input.txt", "some/longer/path/to/a/file.txt", "" };
+
+        auto measure_conversion = [&p_reporter](const std::string& p_name, auto p_value, const auto& p_tokens) {
+            auto result = bench::measure("convert_" + p_name, [&]() {
+                for (const auto token : p_tokens) {
+                    bench::do_not_optimize(cli::impl::parse_value(p_value, token));
+                    bench::do_not_optimize(p_value);
+                }
+            });
+            result.items_per_iteration = p_tokens.size();
+            p_reporter.add(std::move(result));
+        };
+
+        measure_conversion("int", int{}, int_tokens);
+        measure_conversion("double", double{}, double_tokens);
+        measure_conversion("bool", bool{}, bool_tokens);
+        measure_conversion("string", std::string{}, string_tokens);
+        measure_conversion("optional_int", std::optional<int>{}, int_tokens);
+    }
+
+    void run_invocation_benchmarks(bench::reporter& p_reporter) {
+        auto args = std::array{ "path/to/program", "input.txt", "--jobs", "8", "-v", "build" };
+        const auto argc = static_cast<int>(args.size());
+        auto* argv = const_cast<char**>(args.data());
+
+        std::string input;
+        std::optional<int> jobs;
+        std::optional<std::string> output;
+        bool verbose = false;
+        bool debug = false;
+
+        // Schema construction and parsing, as done once per process start.
+        p_reporter.add(bench::measure("invocation_parameters", [&]() {
+            const auto params
+                = cli::option<std::string>{ input, { "input" }, "Input file." }
+                | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" }, "Number of jobs." }
+                | cli::option<std::optional<std::string>>{ output, { "-o", "--output" }, "Output file." }
+                | cli::option_flag<bool>{ verbose, { "-v", "--verbose" }, "Verbose output." }
+                | cli::option_flag<bool>{ debug, { "-d", "--debug" }, "Debug mode." }
+                | cli::command{ { "build" }, "Build." }
+                | cli::command{ { "clean" }, "Clean." }
+                | cli::command{ { "test" }, "Test." };
+
+            auto context = cli::context{}.set_arg(argc, argv);
+            bench::do_not_optimize(params.parse(context));
+        }));
+
+        p_reporter.add(bench::measure("invocation_static_parameters", [&]() {
+            const auto params
+                = cli::static_option<std::string>{ input, "input", "Input file." }
+                | cli::static_option<std::optional<int>>{ jobs, "-j|--jobs", "Number of jobs." }
+                | cli::static_option<std::optional<std::string>>{ output, "-o|--output", "Output file." }
+                | cli::static_option_flag<bool>{ verbose, "-v|--verbose", "Verbose output." }
+                | cli::static_option_flag<bool>{ debug, "-d|--debug", "Debug mode." }
+                | cli::static_command{ "build", "Build." }
+                | cli::static_command{ "clean", "Clean." }
+                | cli::static_command{ "test", "Test." };
+
+            auto context = cli::context{}.set_arg(argc, argv);
+            bench::do_not_optimize(params.parse(context));
+        }));
+    }
+
+    void run_callback_benchmarks(bench::reporter& p_reporter) {
+        auto args = std::array{ "path/to/program", "input.txt", "--jobs", "8", "-v", "build" };
+        const auto argc = static_cast<int>(args.size());
+        auto* argv = const_cast<char**>(args.data());
+
+        std::string input;
+        std::optional<int> jobs;
+        std::optional<std::string> output;
+        bool verbose = false;
+        bool debug = false;
+        int build_count = 0;
+
+        const auto create_parameters = [&]() {
+            return cli::option<std::string>{ input, { "input" }, "Input file." }
+                | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" }, "Number of jobs." }
+                | cli::option<std::optional<std::string>>{ output, { "-o", "--output" }, "Output file." }
+                | cli::option_flag<bool>{ verbose, { "-v", "--verbose" }, "Verbose output." }
+                | cli::option_flag<bool>{ debug, { "-d", "--debug" }, "Debug mode." }
+                | cli::command{ { "build" }, "Build.", [&build_count](cli::context&) { return ++build_count; } }
+                | cli::command{ { "clean" }, "Clean." }
+                | cli::default_error{};
+        };
+
+        p_reporter.add(bench::measure("callback_schema_construction", [&]() {
+            bench::do_not_optimize(create_parameters());
+        }));
+
+        const auto params = create_parameters();
+        p_reporter.add(bench::measure("callback_parse", [&]() {
+            auto context = cli::context{}.set_arg(argc, argv);
+            bench::do_not_optimize(params.parse(context));
+        }));
+    }
+
+    void run_batch_benchmarks(bench::reporter& p_reporter) {
+        constexpr size_t line_count = 100000;
+
+        auto line_storage = std::vector<std::array<std::string, 6>>{};
+        line_storage.reserve(line_count);
+        for (size_t i = 0; i < line_count; i++) {
+            line_storage.push_back({ "path/to/program", "input" + std::to_string(i) + ".txt",
+                "--jobs", std::to_string(i % 64), i % 2 ? "-v" : "-d", i % 3 ? "build" : "clean" });
+        }
+
+        auto pointer_storage = std::vector<std::array<char*, 6>>(line_count);
+        auto lines = std::vector<cli::arguments>(line_count);
+        for (size_t i = 0; i < line_count; i++) {
+            for (size_t j = 0; j < line_storage[i].size(); j++) {
+                pointer_storage[i][j] = line_storage[i][j].data();
+            }
+            lines[i] = cli::arguments{ static_cast<int>(pointer_storage[i].size()), pointer_storage[i].data() };
+        }
+
+        auto params = cli::detached_parameters{};
+        params.add_option<std::string_view>({ "input" }, "Input file.");
+        params.add_option<std::optional<int>>({ "-j", "--jobs" }, "Number of jobs.");
+        params.add_flag({ "-v", "--verbose" }, "Verbose output.");
+        params.add_flag({ "-d", "--debug" }, "Debug mode.");
+        params.add_command({ "build" }, "Build.");
+        params.add_command({ "clean" }, "Clean.");
+
+        auto add_lines_result = [&p_reporter](bench::result p_result) {
+            p_result.items_per_iteration = line_count;
+            p_reporter.add(std::move(p_result));
+        };
+
+        auto results = std::vector<cli::parse_result>(line_count);
+        add_lines_result(bench::measure("batch_parse/1_thread", [&]() {
+            params.parse_batch(lines.data(), lines.size(), results.data());
+            bench::do_not_optimize(results);
+        }));
+
+        const auto thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        add_lines_result(bench::measure("batch_parse/" + std::to_string(thread_count) + "_threads", [&]() {
+            auto threads = std::vector<std::thread>{};
+            const auto chunk_size = (line_count + thread_count - 1) / thread_count;
+            for (size_t begin = 0; begin < line_count; begin += chunk_size) {
+                const auto count = std::min(chunk_size, line_count - begin);
+                threads.emplace_back([&, begin, count]() {
+                    params.parse_batch(lines.data() + begin, count, results.data() + begin);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            bench::do_not_optimize(results);
+        }));
+    }
+
+    void run_response_file_benchmarks(bench::reporter& p_reporter) {
+        constexpr size_t argument_count = 100000;
+        const auto path = std::string{ "cppli_bench_arguments.rsp" };
+        {
+            auto file = std::ofstream{ path };
+            for (size_t i = 0; i < argument_count / 2; i++) {
+                file << (i % 4 == 0 ? "-I \"include dir/" : "-I include/") << i << (i % 4 == 0 ? "\"\n" : "\n");
+            }
+        }
+
+        auto params = cli::detached_parameters{};
+        const auto include_handle = params.add_option<std::optional<std::string_view>>({ "-I" }, "Include directory.");
+
+        const auto argument = "@" + path;
+        auto args = std::array{ "path/to/program", argument.c_str() };
+        const auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+
+        auto expander = cli::response_file_expander{};
+        auto result = cli::parse_result{};
+        p_reporter.add(bench::measure("response_file/100k_arguments", [&]() {
+            expander.expand(context);
+            auto expanded_context = cli::context{}.set_tokens(expander.tokens());
+            params.parse(expanded_context, result);
+            bench::do_not_optimize(result.get(include_handle));
+        }));
+
+        std::remove(path.c_str());
+    }
+
+    void run_config_file_benchmarks(bench::reporter& p_reporter) {
+        constexpr size_t key_count = 5000;
+        const auto path = std::string{ "cppli_bench_config.ini" };
+        {
+            auto file = std::ofstream{ path };
+            file << "# Generated benchmark config.\n";
+            for (size_t i = 0; i < key_count; i++) {
+                file << "option-" << i << " = " << i << "\n";
+            }
+        }
+
+        auto values = std::vector<std::optional<int>>(key_count);
+        auto builder = cli::parameters_builder{}.reserve(0, key_count, 0, 0);
+        for (size_t i = 0; i < key_count; i++) {
+            builder.add_option(cli::option<std::optional<int>>{ values[i], { "--option-" + std::to_string(i) } });
+        }
+        const auto params = builder.build();
+
+        auto config = cli::config_file{};
+        p_reporter.add(bench::measure("config_load/5k_keys", [&]() {
+            bench::do_not_optimize(config.load(path));
+        }));
+
+        auto args = std::array{ "path/to/program" };
+        auto result = bench::measure("config_parse/5k_keys", [&]() {
+            auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data())).set_config(config);
+            bench::do_not_optimize(params.parse(context));
+        });
+        result.items_per_iteration = key_count;
+        p_reporter.add(std::move(result));
+
+        std::remove(path.c_str());
+    }
+
+}
+
+int main(int argc, char** argv) {
+    auto json_path = std::optional<std::string>{};
+    const auto params
+        = cli::parameters{}
+        | cli::option<std::optional<std::string>>{ json_path, { "--json" }, "Write results as JSON to file." }
+        | cli::default_help{}
+        | cli::default_error{};
+
+    auto context = cli::context{}.set_arg(argc, argv);
+    if (const auto code = params.parse(context); code != cli::parse_codes::successful) {
+        return code == cli::parse_codes::successful_help ? 0 : 1;
+    }
+
+    auto reporter = bench::reporter{};
+    run_lookup_benchmarks(reporter);
+    run_nesting_benchmarks(reporter);
+    run_invocation_benchmarks(reporter);
+    run_callback_benchmarks(reporter);
+    run_composition_benchmarks(reporter);
+    run_help_benchmarks(reporter);
+    run_abbreviation_benchmarks(reporter);
+    run_suggestion_benchmarks(reporter);
+    run_completion_benchmarks(reporter);
+    run_getopt_benchmarks(reporter);
+    run_rest_arguments_benchmarks(reporter);
+    run_environment_benchmarks(reporter);
+    run_conversion_benchmarks(reporter);
+    run_batch_benchmarks(reporter);
+    run_response_file_benchmarks(reporter);
+    run_config_file_benchmarks(reporter);
+
+    if (json_path.has_value() && !reporter.write_json(json_path.value())) {
+        std::fprintf(stderr, "Failed to write %s\n", json_path->c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef CPPLI_BENCH_HPP
+#define CPPLI_BENCH_HPP
+
+#include "cppli/cppli.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    struct result {
+        std::string name;
+        size_t iterations;
+        double nanoseconds_per_iteration;
+        size_t items_per_iteration = 1;
+
+        double items_per_second() const {
+            return static_cast<double>(items_per_iteration) * 1e9 / nanoseconds_per_iteration;
+        }
+    };
+
+    template<typename T>
+    inline void do_not_optimize(const T& p_value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(p_value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &p_value;
+#endif
+    }
+
+    template<typename TFunction>
+    inline result measure(std::string p_name, TFunction&& p_function) {
+        using clock = std::chrono::steady_clock;
+        constexpr auto min_duration = std::chrono::milliseconds{ 200 };
+
+        size_t iterations = 1;
+        while (true) {
+            const auto start = clock::now();
+            for (size_t i = 0; i < iterations; i++) {
+                p_function();
+            }
+            const auto duration = clock::now() - start;
+
+            if (duration >= min_duration || iterations >= (size_t{ 1 } << 30)) {
+                const auto nanoseconds = std::chrono::duration<double, std::nano>{ duration }.count();
+                return result{ std::move(p_name), iterations, nanoseconds / static_cast<double>(iterations) };
+            }
+            iterations *= 2;
+        }
+    }
+
+    inline void print(const result& p_result) {
+        std::printf("%-48s %14.1f ns %12zu iterations",
+            p_result.name.c_str(), p_result.nanoseconds_per_iteration, p_result.iterations);
+        if (p_result.items_per_iteration > 1) {
+            std::printf(" %14.0f items/s", p_result.items_per_second());
+        }
+        std::printf("\n");
+    }
+
+    class reporter {
+
+    public:
+
+        void add(result p_result) {
+            print(p_result);
+            m_results.push_back(std::move(p_result));
+        }
+
+        bool write_json(const std::string& p_path) const {
+            auto* file = std::fopen(p_path.c_str(), "w");
+            if (file == nullptr) {
+                return false;
+            }
+
+            std::fprintf(file, "{\n  \"benchmarks\": [\n");
+            for (size_t i = 0; i < m_results.size(); i++) {
+                const auto& current = m_results[i];
+                std::fprintf(file,
+                    "    { \"name\": \"%s\", \"iterations\": %zu, \"ns_per_iteration\": %.3f, "
+                    "\"items_per_iteration\": %zu, \"items_per_second\": %.3f }%s\n",
+                    current.name.c_str(), current.iterations, current.nanoseconds_per_iteration,
+                    current.items_per_iteration, current.items_per_second(),
+                    i + 1 < m_results.size() ? "," : "");
+            }
+            std::fprintf(file, "  ]\n}\n");
+
+            return std::fclose(file) == 0;
+        }
+
+    private:
+
+        std::vector<result> m_results;
+
+    };
+
+}
+
+#endif
@@ -33,18 +33,63 @@
 #include <algorithm>
 #include <functional>
 #include <utility>
+#include <tuple>
 #include <charconv>
 #include <iostream>
 #include <cstring>
 #include <cctype>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <array>
+#include <limits>
+#include <mutex>
+#include <chrono>
+#include <cmath>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <cstdio>
+#include <stdlib.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace cppli::impl {
+
+    static constexpr std::size_t inplace_function_capacity = 4 * sizeof(void*);
+    static constexpr std::size_t callback_capacity = 8 * sizeof(void*);
+
+    template<typename TSignature, std::size_t VCapacity = inplace_function_capacity>
+    class inplace_function;
+
+}
 
 namespace cppli {
 
+    struct parse_error;
     struct error;
     struct default_error;
     struct help;
     struct default_help;
+    struct completion;
+    class path_stack;
     struct context;
+    struct arguments;
+    class argument_span;
+    struct byte_size;
+    class tokenizer;
+    class response_file_expander;
+    class config_file;
 
     struct command;
      
@@ -52,12 +97,25 @@ namespace cppli {
     template<typename T> struct option_flag;
     class option_proxy;
     class option_flag_proxy;
+    struct rest_arguments;
 
     struct parameters;
+    class parameters_builder;
+    class compiled_parameters;
+
+    template<typename T> struct option_handle;
+    struct command_handle;
+    class parse_result;
+    class detached_parameters;
+
+    template<typename T> struct static_option;
+    template<typename T> struct static_option_flag;
+    template<typename TCallback> struct static_command;
+    template<typename... TElements> struct static_parameters;
 
-    using error_callback = std::function<void(context&, std::string)>;
-    using help_callback = std::function<int(context&)>;
-    using command_callback = std::function<int(context&)>;;
+    using error_callback = impl::inplace_function<void(context&, const parse_error&), impl::callback_capacity>;
+    using help_callback = impl::inplace_function<int(context&), impl::callback_capacity>;
+    using command_callback = impl::inplace_function<int(context&), impl::callback_capacity>;
 
     namespace parse_codes {
         static constexpr int successful = 0;
@@ -69,8 +127,16 @@ namespace cppli {
         static constexpr int missing_option = 6;
         static constexpr int missing_option_value = 7;
         static constexpr int invalid_option_value = 8;
+        static constexpr int successful_completion = 9;
+        static constexpr int ambiguous_name = 10;
     }
 
+    enum class completion_shell {
+        bash,
+        zsh,
+        fish
+    };
+
     context operator | (const context& lhs, const error& rhs);
     context operator | (const context& lhs, error&& rhs);
     context operator | (context&& lhs, const error& rhs);
@@ -191,25 +257,102 @@ namespace cppli {
     parameters operator | (const parameters& lhs, help&& rhs);
     parameters operator | (parameters&& lhs, const help& rhs);
     parameters operator | (parameters&& lhs, help&& rhs);
+
+    parameters operator | (const parameters& lhs, const rest_arguments& rhs);
+    parameters operator | (const parameters& lhs, rest_arguments&& rhs);
+    parameters operator | (parameters&& lhs, const rest_arguments& rhs);
+    parameters operator | (parameters&& lhs, rest_arguments&& rhs);
  
 }
 
 namespace cppli::impl {
 
-    std::string_view parse_program_name(const char* path);
+    std::string_view parse_program_name(std::string_view path);
 
     bool handle_first_arg_is_path(context& p_context);
 
     template<typename T>
     const error* get_error_handler(const context& p_context, const T& p_other);
 
-    error_callback get_error_callback(const error* p_error);
+    const error_callback* get_error_callback(const error* p_error);
 
     template<typename T>
     const help* get_help_handler(const context& p_context, const T& p_other);
 
-    using set_value_callback = std::function<bool(std::string_view)>;
-    using set_flag_callback = std::function<void()>;
+    class parameters_schema;
+    class compiled_parameters_schema;
+    class detached_parameters_schema;
+
+    using set_detached_value_callback = bool(*)(void*, std::string_view);
+
+    template<typename T>
+    bool set_detached_value(void* p_slot, std::string_view p_value);
+
+    struct detached_option;
+    struct detached_command;
+
+    template<typename TSchema>
+    int parse_schema(context& p_context, const TSchema& p_schema);
+
+    std::optional<std::string_view> find_schema_environment(context& p_context, std::string_view p_variable);
+
+    argument_span take_rest_arguments(context& p_context);
+
+    template<typename TString>
+    void append_parse_error_message(const parse_error& p_error, TString& p_result);
+
+    enum class name_kind : std::uint8_t;
+
+    template<typename TSchema>
+    std::size_t find_config_option(const TSchema& p_schema, std::string_view p_key, name_kind& p_kind);
+
+    std::pair<const std::string_view*, std::size_t> config_section_path(const context& p_context);
+
+    template<typename TSchema>
+    std::size_t find_short_name_by_lookup(const TSchema& p_schema, char p_name, name_kind& p_kind);
+
+    int parse_command_tree(context& p_context, const parameters& p_parameters, const command* p_owner);
+
+    std::size_t edit_distance(
+        const std::array<std::uint64_t, 256>& p_pattern_masks,
+        std::size_t p_pattern_length,
+        std::string_view p_text,
+        std::size_t p_max_distance = std::numeric_limits<std::size_t>::max());
+
+    template<typename TVisitor>
+    std::size_t suggest_names(std::string_view p_token, std::string_view* p_output, std::size_t p_max_count, TVisitor&& p_visitor);
+
+    template<typename TSchema>
+    std::size_t suggest_schema_names(const void* p_schema, std::string_view p_token, std::string_view* p_output, std::size_t p_max_count);
+
+    template<typename TSchema>
+    std::size_t abbreviation_schema_candidates(const void* p_schema, std::string_view p_token, std::string_view* p_output, std::size_t p_max_count);
+
+    bool is_abbreviation_candidate(std::string_view p_token);
+
+    template<typename TFunction>
+    void complete_names(const parameters& p_parameters, const help* p_help, const argument_span& p_words, TFunction&& p_function);
+
+    std::optional<int> parse_completion(context& p_context, const parameters& p_parameters, const completion& p_completion);
+
+    using set_value_callback = inplace_function<bool(std::string_view)>;
+    using set_flag_callback = inplace_function<void()>;
+
+    template<typename T>
+    bool parse_value(T& p_value, std::string_view p_string);
+
+    template<typename T>
+    bool parse_integer(T& p_value, std::string_view p_string);
+
+    bool parse_byte_size(std::uint64_t& p_value, std::string_view p_string);
+
+    template<typename TRep, typename TPeriod>
+    bool parse_duration(std::chrono::duration<TRep, TPeriod>& p_value, std::string_view p_string);
+
+    bool parse_decimal(long double& p_value, std::string_view& p_string);
+
+    template<typename T>
+    void set_flag_value(T& p_value);
 
     template<typename T>
     set_value_callback create_set_value_callback(T& p_value);
@@ -237,1076 +380,6003 @@ namespace cppli::impl {
     };
 
     template<typename T>
-    using raw_option_type_t = typename raw_option_type<T>::type;
+    constexpr bool is_optional_option_v = is_template_instance_v<T, std::optional> || is_template_instance_v<T, std::vector>;
 
-}
+    template<typename T>
+    struct is_duration : std::false_type {};
 
-namespace cppli {
+    template<typename TRep, typename TPeriod>
+    struct is_duration<std::chrono::duration<TRep, TPeriod>> : std::true_type {};
 
-    struct error {
+    template<typename T>
+    using raw_option_type_t = typename raw_option_type<T>::type;
 
-        error_callback callback;
+    template<typename T>
+    struct static_element_traits {
+        static constexpr bool is_required_option = false;
+        static constexpr bool is_optional_option = false;
+        static constexpr bool is_flag = false;
+        static constexpr bool is_command = false;
+    };
 
-        error& set_callback(const error_callback& p_callback);
-        error& set_callback(error_callback&& p_callback);
+    template<typename T>
+    struct static_element_traits<static_option<T>> {
+        static constexpr bool is_required_option = !is_optional_option_v<T>;
+        static constexpr bool is_optional_option = is_optional_option_v<T>;
+        static constexpr bool is_flag = false;
+        static constexpr bool is_command = false;
+    };
 
+    template<typename T>
+    struct static_element_traits<static_option_flag<T>> {
+        static constexpr bool is_required_option = false;
+        static constexpr bool is_optional_option = false;
+        static constexpr bool is_flag = true;
+        static constexpr bool is_command = false;
     };
 
+    template<typename TCallback>
+    struct static_element_traits<static_command<TCallback>> {
+        static constexpr bool is_required_option = false;
+        static constexpr bool is_optional_option = false;
+        static constexpr bool is_flag = false;
+        static constexpr bool is_command = true;
+    };
 
-    struct default_error : error {
+    template<typename T>
+    struct is_static_required_option : std::bool_constant<static_element_traits<T>::is_required_option> {};
+    template<typename T>
+    struct is_static_optional_option : std::bool_constant<static_element_traits<T>::is_optional_option> {};
+    template<typename T>
+    struct is_static_flag : std::bool_constant<static_element_traits<T>::is_flag> {};
+    template<typename T>
+    struct is_static_command : std::bool_constant<static_element_traits<T>::is_command> {};
 
-        default_error();
+    template<typename T>
+    constexpr bool is_static_element_v =
+        is_static_required_option<std::decay_t<T>>::value ||
+        is_static_optional_option<std::decay_t<T>>::value ||
+        is_static_flag<std::decay_t<T>>::value ||
+        is_static_command<std::decay_t<T>>::value;
 
-        static void default_callback(context& p_context, std::string p_message);
+    template<typename T, typename TResult>
+    using enable_if_static_element_t = std::enable_if_t<is_static_element_v<T>, TResult>;
 
-    };
+    template<template<typename> typename TKind, typename... TElements>
+    constexpr std::size_t count_static_elements();
 
+    template<template<typename> typename TKind, typename TTuple, typename TFunction>
+    bool visit_static_elements(const TTuple& p_elements, TFunction&& p_function);
 
-    struct help {
+    constexpr bool static_names_contain(std::string_view p_names, std::string_view p_name);
+    constexpr std::string_view static_first_name(std::string_view p_names);
+    std::vector<std::string> split_static_names(std::string_view p_names);
 
-        std::vector<std::string> names = { "-h", "--help" };
-        std::string description = "Show command line help.";
-        help_callback callback = {};
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    class inplace_function<TReturn(TArgs...), VCapacity> {
 
-        bool has_names() const;
-        bool has_name(std::string_view p_name) const;
+    public:
 
-        help& set_name(const std::string& p_name);
-        help& set_name(std::string&& p_name);
+        inplace_function() noexcept = default;
+        inplace_function(std::nullptr_t) noexcept;
 
-        help& set_names(std::initializer_list<std::string> p_names);
-        help& set_names(const std::vector<std::string>& p_names);
-        help& set_names(std::vector<std::string>&& p_names);
+        template<typename TCallable, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<TCallable>, inplace_function> &&
+            std::is_invocable_r_v<TReturn, std::decay_t<TCallable>&, TArgs...>>>
+        inplace_function(TCallable&& p_callable);
 
-        help& set_description(const std::string& p_description);
-        help& set_description(std::string&& p_description);
+        inplace_function(const inplace_function& p_other);
+        inplace_function(inplace_function&& p_other) noexcept;
+        ~inplace_function();
 
-        help& set_callback(const help_callback& p_callback);
-        help& set_callback(help_callback&& p_callback);
+        inplace_function& operator = (const inplace_function& p_other);
+        inplace_function& operator = (inplace_function&& p_other) noexcept;
+        inplace_function& operator = (std::nullptr_t) noexcept;
 
-    };
+        explicit operator bool() const noexcept;
 
+        TReturn operator()(TArgs... p_args) const;
 
-    struct default_help : help {
+    private:
 
-        explicit default_help(std::vector<std::string> names = { "-h", "--help" });
+        struct vtable {
+            TReturn(*invoke)(void*, TArgs&&...);
+            void(*copy)(void*, const void*);
+            void(*move)(void*, void*) noexcept;
+            void(*destroy)(void*) noexcept;
+        };
 
-        static int default_callback(context& p_context);
+        template<typename TCallable>
+        static const vtable* get_vtable();
 
-        static std::string default_string(
-            const context& p_context,
-            const parameters& p_parameters);
+        void reset() noexcept;
 
-        static std::string join_names(const std::vector<std::string>& names);
+        alignas(std::max_align_t) mutable unsigned char m_storage[VCapacity];
+        const vtable* m_vtable = nullptr;
 
     };
 
+    struct detached_option {
+        std::vector<std::string> names;
+        std::string description;
+        set_detached_value_callback set_value;
+        std::size_t index;
+        std::size_t offset;
+    };
 
-    struct context {
+    struct detached_command {
+        std::vector<std::string> names;
+        std::string description;
+    };
 
-        int argc = 0;
-        char** argv = nullptr;
-        bool first_arg_is_path = true;
-        std::optional<error> error_handler = {};
-        std::optional<help> help_handler = {};
-        std::vector<std::string> current_path = {};
-        std::optional<std::reference_wrapper<const parameters>> current_parameter_group = {};
+    enum class name_kind : std::uint8_t {
+        flag = 0,
+        optional = 1,
+        command = 2,
+        required = 3
+    };
 
-        context& set_arg(int p_argc, char** p_argv);
-        context& set_argc(int p_argc);
-        context& set_argv(char** p_argv);
+    std::uint32_t hash_name(std::string_view p_name);
 
-        context& set_error(const error& p_error);
-        context& set_error(error&& p_error);
+    template<typename T>
+    const T* find_by_name(const std::vector<T>& p_items, std::string_view p_name);
 
-        context& set_help(const help& p_help);
-        context& set_help(help&& p_help);
+    template<typename T>
+    class resource_allocator {
 
-        context& move_to_next_arg();
+    public:
 
-    };
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
 
+        resource_allocator() noexcept;
+        resource_allocator(std::pmr::memory_resource* p_resource) noexcept;
+        template<typename U>
+        resource_allocator(const resource_allocator<U>& p_other) noexcept;
 
-    struct command {
+        T* allocate(std::size_t p_count);
+        void deallocate(T* p_pointer, std::size_t p_count) noexcept;
 
-        std::vector<std::string> names = {};
-        std::string description = "";
-        command_callback callback = {};
+        std::pmr::memory_resource* resource() const noexcept;
 
-        bool has_name(std::string_view p_name) const;
+        template<typename U>
+        bool operator == (const resource_allocator<U>& p_other) const noexcept;
+        template<typename U>
+        bool operator != (const resource_allocator<U>& p_other) const noexcept;
 
-        command& set_name(const std::string& p_name);
-        command& set_name(std::string&& p_name);
+    private:
 
-        command& set_names(std::initializer_list<std::string> p_names);
-        command& set_names(const std::vector<std::string>& p_names);
-        command& set_names(std::vector<std::string>&& p_names);
+        std::pmr::memory_resource* m_resource;
 
-        command& set_description(const std::string& p_description);
-        command& set_description(std::string&& p_description);
+    };
 
-        command& set_callback(const command_callback& p_callback);
-        command& set_callback(command_callback&& p_callback);
+    template<typename T>
+    using resource_vector = std::vector<T, resource_allocator<T>>;
 
-    };
+    using resource_string = std::basic_string<char, std::char_traits<char>, resource_allocator<char>>;
 
+    class environment_index {
 
-    template<typename T>
-    struct option {
-        T& value;
-        std::vector<std::string> names = {};
-        std::string description = "";
+    public:
 
-        option& set_name(const std::string& p_name);
-        option& set_name(std::string&& p_name);
+        void clear();
 
-        option& set_names(std::initializer_list<std::string> p_names);
-        option& set_names(const std::vector<std::string>& p_names);
-        option& set_names(std::vector<std::string>&& p_names);
+        void set_memory_resource(std::pmr::memory_resource* p_resource);
 
-        option& set_description(const std::string& p_description);
-        option& set_description(std::string&& p_description);
+        std::optional<std::string_view> find(char** p_environment, std::string_view p_name);
 
-    };
+    private:
 
+        struct slot {
+            std::string_view name;
+            std::string_view value;
+        };
 
-    class option_proxy {
+        void build(char** p_environment);
 
-    public:
+        resource_vector<slot> m_slots = {};
+        bool m_built = false;
 
-        std::vector<std::string> names = {};
-        std::string description = "";
+    };
 
-        template<typename T>
-        option_proxy(const option<T>& p_option);
-        template<typename T>
-        option_proxy(option<T>&& p_option);
+    class option_marks {
 
-        option_proxy(const option_proxy&) = default;
-        option_proxy(option_proxy&&) = default;
-        option_proxy& operator = (const option_proxy&) = default;
-        option_proxy& operator = (option_proxy&&) = default;
+    public:
 
-        bool has_name(std::string_view p_name) const;
-        bool has_names() const;
+        static constexpr std::size_t inline_capacity = 256;
 
-        bool set_value(std::string_view p_value) const;
+        explicit option_marks(std::pmr::memory_resource* p_resource);
+
+        void mark(name_kind p_kind, std::size_t p_index);
+
+        bool is_marked(name_kind p_kind, std::size_t p_index) const;
 
     private:
 
-        impl::set_value_callback m_set_value_callback;
+        static std::size_t bit_position(name_kind p_kind, std::size_t p_index);
+
+        std::array<std::uint64_t, inline_capacity / 64> m_inline = {};
+        resource_vector<std::uint64_t> m_overflow;
 
     };
 
+    class short_name_table {
 
-    template<typename T = bool>
-    struct option_flag {
-        T& value;
-        std::vector<std::string> names = {};
-        std::string description = "";
+    public:
 
-        option_flag& set_name(const std::string& p_name);
-        option_flag& set_name(std::string&& p_name);
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
 
-        option_flag& set_names(std::initializer_list<std::string> p_names);
-        option_flag& set_names(const std::vector<std::string>& p_names);
-        option_flag& set_names(std::vector<std::string>&& p_names);
+        void clear();
 
-        option_flag& set_description(const std::string& p_description);
-        option_flag& set_description(std::string&& p_description);
-    };
+        void add(name_kind p_kind, std::size_t p_item, std::string_view p_name);
 
+        std::size_t find(char p_name, name_kind& p_kind) const;
 
-    class option_flag_proxy {
+    private:
+
+        struct entry {
+            std::uint32_t item;
+            name_kind kind;
+            bool used;
+        };
+
+        std::array<entry, 128> m_entries = {};
+
+    };
+
+    class name_index {
 
     public:
 
-        std::vector<std::string> names = {};
-        std::string description = "";
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
 
-        template<typename T>
-        option_flag_proxy(const option_flag<T>& p_option_flag);
-        template<typename T>
-        option_flag_proxy(option_flag<T>&& p_option_flag);
+        void clear();
 
-        option_flag_proxy(const option_flag_proxy&) = default;
-        option_flag_proxy(option_flag_proxy&&) = default;
-        option_flag_proxy& operator = (const option_flag_proxy&) = default;
-        option_flag_proxy& operator = (option_flag_proxy&&) = default;
+        void reserve(std::size_t p_name_count);
 
-        bool has_name(std::string_view p_name) const;
-        bool has_names() const;
+        bool covers(name_kind p_kind, std::size_t p_item_count) const;
 
-        bool set_flag() const;
+        template<typename TOwner>
+        void add_item(name_kind p_kind, const std::vector<std::string>& p_names, const TOwner& p_owner);
+
+        template<typename TOwner>
+        std::size_t find(name_kind p_kind, std::string_view p_name, const TOwner& p_owner) const;
+
+        std::size_t find_short(char p_name, name_kind& p_kind) const;
 
     private:
 
-        impl::set_flag_callback m_set_flag_callback;
-    };
+        struct slot {
+            std::uint32_t hash;
+            std::uint32_t item;
+            std::uint16_t alias;
+            name_kind kind;
+            bool used;
+        };
 
+        static std::size_t start_position(name_kind p_kind, std::uint32_t p_hash, std::size_t p_mask);
 
-    struct parameters {
+        void grow();
+        void rehash(std::size_t p_size);
 
-        std::vector<option_proxy> required_options = {};
-        std::vector<option_proxy> optional_options = {};
-        std::vector<option_flag_proxy> flag_options = {};
-        std::vector<command> commands = {};
-        std::optional<error> error_handler = {};
-        std::optional<help> help_handler = {};
+        std::vector<slot> m_slots = {};
+        std::size_t m_used = 0;
+        std::array<std::size_t, 4> m_item_counts = {};
+        short_name_table m_short_names = {};
 
-        int parse(context& p_context) const;
+    };
 
-        template<typename T>
-        parameters& add_option(const option<T>& p_option);
-        template<typename T>
-        parameters& add_option(option<T>&& p_option);
+    class help_cache {
 
-        template<typename T>
-        parameters& add_option(const option_flag<T>& p_option_flag);
-        template<typename T>
-        parameters& add_option(option_flag<T>&& p_option_flag);
+    public:
 
-        parameters& add_command(const command& p_command);
-        parameters& add_command(command&& p_command);
+        help_cache() = default;
+        help_cache(const help_cache&) noexcept;
+        help_cache& operator = (const help_cache&) noexcept;
 
-        parameters& add_parameters(parameters&& p_parameters);
-        parameters& add_parameters(const parameters& p_parameters);
+        std::shared_ptr<const std::string> get(const parameters& p_parameters, const help* p_help) const;
 
-        parameters& set_error(const error& p_error);
-        parameters& set_error(error&& p_error);
+        void invalidate() noexcept;
 
-        parameters& set_help(const help& p_help);
-        parameters& set_help(help&& p_help);
+        void clear() const;
+
+    private:
+
+        static std::string render(const parameters& p_parameters, const help* p_help);
+
+        std::uint64_t m_generation = 0;
+        mutable std::mutex m_mutex = {};
+        mutable std::uint64_t m_body_generation = 0;
+        mutable const help* m_body_help = nullptr;
+        mutable std::shared_ptr<const std::string> m_body = {};
 
     };
 
-}
+    class abbreviation_index {
 
+    public:
 
-// Implementations.
-namespace cppli::impl {
+        abbreviation_index() = default;
+        abbreviation_index(const abbreviation_index&) noexcept;
+        abbreviation_index& operator = (const abbreviation_index&) noexcept;
 
-    inline std::string_view parse_program_name(const char* path) {
-        const auto path_view = std::string_view{ path, strlen(path) };
+        std::string_view expand(const parameters& p_parameters, std::string_view p_name, bool& p_ambiguous) const;
 
-        const auto last_dir_pos = path_view.find_last_of("/\\");
-        const auto program_offset = last_dir_pos != std::string_view::npos ? last_dir_pos + 1 : 0;
-        const auto program_exe_len = path_view.size() - program_offset;
+        std::size_t candidates(const parameters& p_parameters, std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const;
 
-        const auto program_exe_view = std::string_view{ path_view.data() + program_offset, program_exe_len };
+        void clear() const;
 
-        const auto last_ext_pos = program_exe_view.find_last_of('.');
-        const auto program_len = last_ext_pos != std::string_view::npos ? last_ext_pos : program_exe_view.size();
+    private:
 
-        return std::string_view{ program_exe_view.data(), program_len };
-    }
+        struct entry {
+            std::string_view name;
+            std::uint32_t item;
+            std::uint32_t item_changes;
+        };
 
-    inline bool handle_first_arg_is_path(context& p_context) {
-        if (p_context.first_arg_is_path) {
-            if (p_context.argc <= 0) {
-                return false;
-            }
+        struct table {
+            std::array<std::size_t, 3> item_counts = {};
+            std::vector<entry> entries = {};
+        };
+
+        using entry_range = std::pair<const entry*, const entry*>;
+
+        static std::array<std::size_t, 3> item_counts(const parameters& p_parameters);
+
+        static std::shared_ptr<const table> build(const parameters& p_parameters);
+
+        static entry_range find_prefix(const table& p_table, std::string_view p_prefix);
+
+        std::shared_ptr<const table> get(const parameters& p_parameters) const;
+
+        mutable std::mutex m_mutex = {};
+        mutable std::shared_ptr<const table> m_table = {};
+
+    };
+
+    class mapped_file {
+
+    public:
+
+        mapped_file() = default;
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator = (const mapped_file&) = delete;
+
+        bool open(const std::string& p_path);
+        void close();
+
+        std::string_view content() const;
+
+    private:
+
+#if defined(_WIN32)
+        std::unique_ptr<char[]> m_buffer = {};
+#else
+        void* m_mapping = nullptr;
+#endif
+        std::size_t m_size = 0;
+
+    };
+
+    bool write_fd(int p_fd, std::string_view p_first, std::string_view p_second, std::string_view p_third);
+
+}
+
+namespace cppli {
+
+    template<typename TLhs, typename TRhs>
+    impl::enable_if_static_element_t<TLhs, impl::enable_if_static_element_t<TRhs,
+        static_parameters<std::decay_t<TLhs>, std::decay_t<TRhs>>>> operator | (TLhs&& lhs, TRhs&& rhs);
+
+    template<typename... TElements, typename TRhs>
+    impl::enable_if_static_element_t<TRhs, static_parameters<TElements..., std::decay_t<TRhs>>>
+        operator | (const static_parameters<TElements...>& lhs, TRhs&& rhs);
+    template<typename... TElements, typename TRhs>
+    impl::enable_if_static_element_t<TRhs, static_parameters<TElements..., std::decay_t<TRhs>>>
+        operator | (static_parameters<TElements...>&& lhs, TRhs&& rhs);
+
+    template<typename... TElements>
+    static_parameters<TElements...> operator | (const static_parameters<TElements...>& lhs, const error& rhs);
+    template<typename... TElements>
+    static_parameters<TElements...> operator | (static_parameters<TElements...>&& lhs, const error& rhs);
+
+    template<typename... TElements>
+    static_parameters<TElements...> operator | (const static_parameters<TElements...>& lhs, const help& rhs);
+    template<typename... TElements>
+    static_parameters<TElements...> operator | (static_parameters<TElements...>&& lhs, const help& rhs);
+
+}
+
+namespace cppli {
+
+    // Token, name and suggestions() view the arguments and schema of the running parse, so are only valid within the error callback.
+    struct parse_error {
+
+        int code = parse_codes::successful;
+        std::string_view token = {};
+        std::string_view name = {};
+        int arg_index = 0;
+        const void* suggestion_source = nullptr;
+        std::size_t(*suggestion_function)(const void*, std::string_view, std::string_view*, std::size_t) = nullptr;
+
+        static constexpr std::size_t max_suggestions = 3;
+
+        std::size_t suggestions(std::string_view* p_output, std::size_t p_max_count = max_suggestions) const;
+
+        std::string message() const;
+        std::pmr::string message(std::pmr::memory_resource* p_resource) const;
+        operator std::string() const;
+
+    };
+
+
+    struct error {
+
+        error_callback callback;
+
+        error& set_callback(const error_callback& p_callback);
+        error& set_callback(error_callback&& p_callback);
+
+    };
+
+
+    struct default_error : error {
+
+        default_error();
+
+        static void default_callback(context& p_context, const parse_error& p_error);
+
+    };
+
+
+    struct help {
+
+        std::vector<std::string> names = { "-h", "--help" };
+        std::string description = "Show command line help.";
+        help_callback callback = {};
+
+        bool has_names() const;
+        bool has_name(std::string_view p_name) const;
+
+        help& set_name(const std::string& p_name);
+        help& set_name(std::string&& p_name);
+
+        help& set_names(std::initializer_list<std::string> p_names);
+        help& set_names(const std::vector<std::string>& p_names);
+        help& set_names(std::vector<std::string>&& p_names);
+
+        help& set_description(const std::string& p_description);
+        help& set_description(std::string&& p_description);
+
+        help& set_callback(const help_callback& p_callback);
+        help& set_callback(help_callback&& p_callback);
+
+    };
+
+
+    struct default_help : help {
+
+        explicit default_help(std::vector<std::string> names = { "-h", "--help" });
+
+        static int default_callback(context& p_context);
+
+        static std::string default_string(
+            const context& p_context,
+            const parameters& p_parameters);
+
+        static std::string join_names(const std::vector<std::string>& names);
+
+    };
+
+
+    struct completion {
+
+        std::string name = "__complete";
+
+        completion& set_name(const std::string& p_name);
+        completion& set_name(std::string&& p_name);
+
+        std::string script(completion_shell p_shell, std::string_view p_program_name) const;
+
+        static std::size_t candidates(
+            const parameters& p_parameters,
+            const std::string_view* p_words,
+            std::size_t p_count,
+            std::vector<std::string_view>& p_output);
+
+    };
+
+
+    class path_stack {
+
+    public:
+
+        static constexpr std::size_t inline_capacity = 8;
+
+        path_stack() = default;
+        path_stack(std::initializer_list<std::string_view> p_names);
+        explicit path_stack(std::pmr::memory_resource* p_resource);
+
+        path_stack(const path_stack& p_other);
+        path_stack(path_stack&& p_other) noexcept;
+        path_stack& operator = (const path_stack& p_other);
+        path_stack& operator = (path_stack&& p_other) noexcept;
+
+        ~path_stack();
+
+        bool empty() const;
+        std::size_t size() const;
+        std::size_t capacity() const;
+
+        const std::string_view* data() const;
+        const std::string_view& operator [] (std::size_t p_index) const;
+        const std::string_view& front() const;
+        const std::string_view& back() const;
+
+        const std::string_view* begin() const;
+        const std::string_view* end() const;
+
+        void push_back(std::string_view p_name);
+        void emplace_back(std::string_view p_name);
+        void pop_back();
+        void clear();
+        void reserve(std::size_t p_capacity);
+
+        std::pmr::memory_resource* resource() const;
+
+    private:
+
+        void release();
+
+        std::array<std::string_view, inline_capacity> m_inline = {};
+        std::string_view* m_heap = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_capacity = inline_capacity;
+        std::pmr::memory_resource* m_resource = std::pmr::get_default_resource();
+
+    };
+
+
+    struct context {
+
+        int argc = 0;
+        char** argv = nullptr;
+        bool first_arg_is_path = true;
+        std::optional<error> error_handler = {};
+        std::optional<help> help_handler = {};
+        path_stack current_path = {};
+        std::optional<std::reference_wrapper<const parameters>> current_parameter_group = {};
+        int arg_index = 0;
+        int output_fd = 1;
+        const std::string_view* tokens = nullptr;
+        char** environment = nullptr;
+        impl::environment_index environment_index = {};
+        const config_file* config = nullptr;
+        path_stack command_path = {};
+
+        context& set_arg(int p_argc, char** p_argv);
+        context& set_argc(int p_argc);
+        context& set_argv(char** p_argv);
+
+        context& set_tokens(const std::string_view* p_tokens, std::size_t p_count);
+        context& set_tokens(const std::vector<std::string_view>& p_tokens);
+
+        std::string_view current_arg() const;
+
+        context& set_environment(char** p_environment);
+        std::optional<std::string_view> find_environment(std::string_view p_name);
+
+        context& set_config(const config_file& p_config);
+
+        context& set_memory_resource(std::pmr::memory_resource* p_resource);
+        std::pmr::memory_resource* memory_resource() const;
+
+        context& reset();
+
+        context& set_error(const error& p_error);
+        context& set_error(error&& p_error);
+
+        context& set_help(const help& p_help);
+        context& set_help(help&& p_help);
+
+        context& move_to_next_arg();
+
+    };
+
+
+    struct arguments {
+
+        int argc = 0;
+        char** argv = nullptr;
+
+    };
+
+
+    class argument_span {
+
+    public:
+
+        class iterator {
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = std::string_view;
+
+            iterator(const argument_span& p_span, std::size_t p_index);
+
+            std::string_view operator * () const;
+            iterator& operator ++ ();
+            iterator operator ++ (int);
+
+            bool operator == (const iterator& p_other) const;
+            bool operator != (const iterator& p_other) const;
+
+        private:
+
+            const argument_span* m_span;
+            std::size_t m_index;
+
+        };
+
+        argument_span() = default;
+        argument_span(char** p_argv, std::size_t p_size);
+        argument_span(const std::string_view* p_tokens, std::size_t p_size);
+
+        std::size_t size() const;
+        bool empty() const;
+
+        std::string_view operator [] (std::size_t p_index) const;
+
+        char** argv() const;
+        const std::string_view* tokens() const;
+
+        iterator begin() const;
+        iterator end() const;
+
+    private:
+
+        char** m_argv = nullptr;
+        const std::string_view* m_tokens = nullptr;
+        std::size_t m_size = 0;
+
+    };
+
+
+    struct byte_size {
+
+        std::uint64_t bytes = 0;
+
+        bool operator == (const byte_size& p_other) const;
+        bool operator != (const byte_size& p_other) const;
+
+    };
+
+
+    class tokenizer {
+
+    public:
+
+        bool tokenize(std::string_view p_line);
+
+        const std::vector<std::string_view>& tokens() const;
+
+    private:
+
+        std::vector<std::string_view> m_tokens = {};
+        std::unique_ptr<char[]> m_arena = {};
+        std::size_t m_arena_size = 0;
+
+    };
+
+
+    class response_file_expander {
+
+    public:
+
+        std::size_t max_depth = 8;
+
+        bool expand(const context& p_context);
+
+        const std::vector<std::string_view>& tokens() const;
+
+    private:
+
+        bool expand_file(std::string_view p_path, std::size_t p_depth);
+
+        struct source {
+            impl::mapped_file file;
+            cppli::tokenizer tokenizer;
+        };
+
+        std::vector<std::unique_ptr<source>> m_sources = {};
+        std::size_t m_used_sources = 0;
+        std::vector<std::string_view> m_tokens = {};
+
+    };
+
+
+    class config_file {
+
+    public:
+
+        struct entry {
+            std::string_view section;
+            std::string_view key;
+            std::string_view value;
+            std::size_t line;
+        };
+
+        bool load(const std::string& p_path);
+        bool load_string(std::string_view p_content);
+
+        std::size_t error_line() const;
+
+        const std::vector<entry>& entries() const;
+
+        std::optional<std::string_view> find(const std::string_view* p_path, std::size_t p_depth, std::string_view p_key) const;
+
+        template<typename TFunction>
+        void visit_section(const std::string_view* p_path, std::size_t p_depth, TFunction&& p_function) const;
+
+    private:
+
+        struct section {
+            std::string_view name;
+            std::size_t first;
+            std::size_t last;
+        };
+
+        bool parse(std::string_view p_content);
+
+        static bool section_matches(std::string_view p_section, const std::string_view* p_path, std::size_t p_depth);
+
+        impl::mapped_file m_file = {};
+        std::vector<entry> m_entries = {};
+        std::vector<section> m_sections = {};
+        std::size_t m_error_line = 0;
+
+    };
+
+
+    struct command {
+
+        std::vector<std::string> names = {};
+        std::string description = "";
+        command_callback callback = {};
+        std::shared_ptr<const parameters> child_parameters = {};
+
+        bool has_name(std::string_view p_name) const;
+
+        command& set_name(const std::string& p_name);
+        command& set_name(std::string&& p_name);
+
+        command& set_names(std::initializer_list<std::string> p_names);
+        command& set_names(const std::vector<std::string>& p_names);
+        command& set_names(std::vector<std::string>&& p_names);
+
+        command& set_description(const std::string& p_description);
+        command& set_description(std::string&& p_description);
+
+        command& set_callback(const command_callback& p_callback);
+        command& set_callback(command_callback&& p_callback);
+
+        command& set_child_parameters(parameters p_parameters);
+        command& set_child_parameters(std::shared_ptr<const parameters> p_parameters);
+
+    };
+
+
+    template<typename T>
+    struct option {
+        T& value;
+        std::vector<std::string> names = {};
+        std::string description = "";
+        std::string environment = "";
+
+        option& set_name(const std::string& p_name);
+        option& set_name(std::string&& p_name);
+
+        option& set_names(std::initializer_list<std::string> p_names);
+        option& set_names(const std::vector<std::string>& p_names);
+        option& set_names(std::vector<std::string>&& p_names);
+
+        option& set_description(const std::string& p_description);
+        option& set_description(std::string&& p_description);
+
+        option& set_environment(const std::string& p_environment);
+        option& set_environment(std::string&& p_environment);
+
+    };
+
+
+    class option_proxy {
+
+    public:
+
+        std::vector<std::string> names = {};
+        std::string description = "";
+        std::string environment = "";
+
+        template<typename T>
+        option_proxy(const option<T>& p_option);
+        template<typename T>
+        option_proxy(option<T>&& p_option);
+
+        option_proxy(const option_proxy&) = default;
+        option_proxy(option_proxy&&) = default;
+        option_proxy& operator = (const option_proxy&) = default;
+        option_proxy& operator = (option_proxy&&) = default;
+
+        bool has_name(std::string_view p_name) const;
+        bool has_names() const;
+
+        bool set_value(std::string_view p_value) const;
+
+    private:
+
+        friend class compiled_parameters;
+
+        impl::set_value_callback m_set_value_callback;
+
+    };
+
+
+    template<typename T = bool>
+    struct option_flag {
+        T& value;
+        std::vector<std::string> names = {};
+        std::string description = "";
+        std::string environment = "";
+
+        option_flag& set_name(const std::string& p_name);
+        option_flag& set_name(std::string&& p_name);
+
+        option_flag& set_names(std::initializer_list<std::string> p_names);
+        option_flag& set_names(const std::vector<std::string>& p_names);
+        option_flag& set_names(std::vector<std::string>&& p_names);
+
+        option_flag& set_description(const std::string& p_description);
+        option_flag& set_description(std::string&& p_description);
+
+        option_flag& set_environment(const std::string& p_environment);
+        option_flag& set_environment(std::string&& p_environment);
+    };
+
+
+    class option_flag_proxy {
+
+    public:
+
+        std::vector<std::string> names = {};
+        std::string description = "";
+        std::string environment = "";
+
+        template<typename T>
+        option_flag_proxy(const option_flag<T>& p_option_flag);
+        template<typename T>
+        option_flag_proxy(option_flag<T>&& p_option_flag);
+
+        option_flag_proxy(const option_flag_proxy&) = default;
+        option_flag_proxy(option_flag_proxy&&) = default;
+        option_flag_proxy& operator = (const option_flag_proxy&) = default;
+        option_flag_proxy& operator = (option_flag_proxy&&) = default;
+
+        bool has_name(std::string_view p_name) const;
+        bool has_names() const;
+
+        bool set_flag() const;
+
+    private:
+
+        friend class compiled_parameters;
+
+        impl::set_flag_callback m_set_flag_callback;
+    };
+
+
+    struct rest_arguments {
+        argument_span* value;
+        std::string name = "args";
+
+        rest_arguments(argument_span& p_value, std::string p_name = "args");
+
+        rest_arguments& set_name(const std::string& p_name);
+        rest_arguments& set_name(std::string&& p_name);
+    };
+
+
+    struct parameters {
+
+        std::vector<option_proxy> required_options = {};
+        std::vector<option_proxy> optional_options = {};
+        std::vector<option_flag_proxy> flag_options = {};
+        std::vector<command> commands = {};
+        std::optional<error> error_handler = {};
+        std::optional<help> help_handler = {};
+        std::optional<completion> completion_handler = {};
+        std::optional<rest_arguments> rest_handler = {};
+        bool allow_abbreviations = false;
+
+        int parse(context& p_context) const;
+
+        template<typename T>
+        parameters& add_option(const option<T>& p_option);
+        template<typename T>
+        parameters& add_option(option<T>&& p_option);
+
+        template<typename T>
+        parameters& add_option(const option_flag<T>& p_option_flag);
+        template<typename T>
+        parameters& add_option(option_flag<T>&& p_option_flag);
+
+        parameters& add_command(const command& p_command);
+        parameters& add_command(command&& p_command);
+
+        parameters& add_parameters(parameters&& p_parameters);
+        parameters& add_parameters(const parameters& p_parameters);
+
+        parameters& set_error(const error& p_error);
+        parameters& set_error(error&& p_error);
+
+        parameters& set_help(const help& p_help);
+        parameters& set_help(help&& p_help);
+
+        parameters& set_completion(const completion& p_completion);
+        parameters& set_completion(completion&& p_completion);
+
+        parameters& set_rest_arguments(const rest_arguments& p_rest_arguments);
+        parameters& set_rest_arguments(rest_arguments&& p_rest_arguments);
+
+        parameters& set_abbreviations(bool p_allow = true);
+
+        const option_flag_proxy* find_flag(std::string_view p_name) const;
+        const option_proxy* find_optional(std::string_view p_name) const;
+        const command* find_command(std::string_view p_name) const;
+
+        // Items added through add_* are indexed as they come. The indexes and the cached help view the names, so items
+        // pushed, replaced, renamed or redescribed in place are unsupported once parsing has started, until this is called.
+        parameters& rebuild_index();
+
+        compiled_parameters compile(std::pmr::memory_resource* p_resource = std::pmr::get_default_resource()) const;
+
+    private:
+
+        friend struct default_help;
+        friend class parameters_builder;
+        friend class impl::name_index;
+        friend class impl::parameters_schema;
+        friend class impl::compiled_parameters_schema;
+
+        const std::string* indexed_name(impl::name_kind p_kind, std::size_t p_item, std::size_t p_alias) const;
+
+        parameters& index_appended(std::size_t p_optional_option_offset, std::size_t p_flag_option_offset, std::size_t p_command_offset);
+
+        void add_environment_item(impl::name_kind p_kind, std::size_t p_index, const std::string& p_environment);
+
+        std::vector<std::pair<impl::name_kind, std::size_t>> m_environment_items = {};
+        impl::name_index m_lookup_index = {};
+        impl::help_cache m_help_cache = {};
+        impl::abbreviation_index m_abbreviation_index = {};
+
+    };
+
+
+    class parameters_builder {
+
+    public:
+
+        parameters_builder& reserve(
+            std::size_t p_required_option_count,
+            std::size_t p_optional_option_count,
+            std::size_t p_flag_option_count,
+            std::size_t p_command_count);
+
+        template<typename T>
+        parameters_builder& add_option(const option<T>& p_option);
+        template<typename T>
+        parameters_builder& add_option(option<T>&& p_option);
+
+        template<typename T>
+        parameters_builder& add_option(const option_flag<T>& p_option_flag);
+        template<typename T>
+        parameters_builder& add_option(option_flag<T>&& p_option_flag);
+
+        parameters_builder& add_command(const command& p_command);
+        parameters_builder& add_command(command&& p_command);
+
+        parameters_builder& set_error(const error& p_error);
+        parameters_builder& set_error(error&& p_error);
+
+        parameters_builder& set_help(const help& p_help);
+        parameters_builder& set_help(help&& p_help);
+
+        parameters_builder& set_completion(const completion& p_completion);
+        parameters_builder& set_completion(completion&& p_completion);
+
+        parameters_builder& set_rest_arguments(const rest_arguments& p_rest_arguments);
+        parameters_builder& set_rest_arguments(rest_arguments&& p_rest_arguments);
+
+        parameters_builder& set_abbreviations(bool p_allow = true);
+
+        parameters build();
+
+    private:
+
+        parameters m_parameters = {};
+
+    };
+
+
+    // Names, lookup slots and setters of one node are flat arrays, the rest is served by a copy of the source parameters.
+    class compiled_parameters {
+
+    public:
+
+        compiled_parameters() = default;
+        explicit compiled_parameters(const parameters& p_parameters, std::pmr::memory_resource* p_resource = std::pmr::get_default_resource());
+
+        int parse(context& p_context) const;
+
+        const parameters& source() const;
+
+        std::size_t name_count() const;
+        std::string_view name(std::size_t p_index) const;
+
+    private:
+
+        friend class impl::compiled_parameters_schema;
+
+        static constexpr std::uint32_t no_name = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t add_name(impl::name_kind p_kind, std::size_t p_item, std::string_view p_name);
+        std::uint32_t add_names(impl::name_kind p_kind, std::size_t p_item, const std::vector<std::string>& p_names);
+        void build_lookup();
+
+        std::size_t find(impl::name_kind p_kind, std::string_view p_name) const;
+        std::string_view first_name(std::uint32_t p_name) const;
+
+        impl::resource_string m_name_arena = {};
+        impl::resource_vector<std::uint32_t> m_name_offsets = {};
+        impl::resource_vector<std::uint32_t> m_name_hashes = {};
+        impl::resource_vector<impl::name_kind> m_name_kinds = {};
+        impl::resource_vector<std::uint32_t> m_name_items = {};
+        impl::resource_vector<std::uint32_t> m_lookup_slots = {};
+        impl::short_name_table m_short_names = {};
+
+        impl::resource_vector<std::uint32_t> m_required_names = {};
+        impl::resource_vector<std::uint32_t> m_optional_names = {};
+        impl::resource_vector<std::uint32_t> m_command_names = {};
+
+        impl::resource_vector<impl::set_value_callback> m_required_setters = {};
+        impl::resource_vector<impl::set_value_callback> m_optional_setters = {};
+        impl::resource_vector<impl::set_flag_callback> m_flag_setters = {};
+        impl::resource_vector<command_callback> m_command_callbacks = {};
+
+        std::shared_ptr<const parameters> m_source = {};
+
+    };
+
+
+    template<typename T>
+    struct option_handle {
+        std::size_t index = 0;
+        std::size_t offset = 0;
+    };
+
+
+    struct command_handle {
+        std::size_t index = 0;
+    };
+
+
+    class parse_result {
+
+    public:
+
+        int code = parse_codes::successful;
+
+        template<typename T>
+        bool has(option_handle<T> p_handle) const;
+        bool has(command_handle p_handle) const;
+
+        template<typename T>
+        T get(option_handle<T> p_handle) const;
+
+        std::optional<command_handle> command() const;
+
+    private:
+
+        friend class detached_parameters;
+        friend class impl::detached_parameters_schema;
+
+        static constexpr std::size_t no_command = std::numeric_limits<std::size_t>::max();
+
+        void reset(std::size_t p_storage_size, std::size_t p_option_count);
+
+        void* slot(std::size_t p_offset);
+        const void* slot(std::size_t p_offset) const;
+
+        void set(std::size_t p_index);
+
+        std::vector<std::max_align_t> m_storage = {};
+        std::vector<std::uint64_t> m_set_options = {};
+        std::size_t m_command = no_command;
+
+    };
+
+
+    class detached_parameters {
+
+    public:
+
+        std::optional<error> error_handler = {};
+        std::optional<help> help_handler = {};
+
+        template<typename T>
+        option_handle<T> add_option(std::vector<std::string> p_names, std::string p_description = "");
+
+        option_handle<bool> add_flag(std::vector<std::string> p_names, std::string p_description = "");
+
+        command_handle add_command(std::vector<std::string> p_names, std::string p_description = "");
+
+        detached_parameters& set_error(const error& p_error);
+        detached_parameters& set_error(error&& p_error);
+
+        detached_parameters& set_help(const help& p_help);
+        detached_parameters& set_help(help&& p_help);
+
+        parse_result parse(context& p_context) const;
+        int parse(context& p_context, parse_result& p_result) const;
+
+        void parse_batch(
+            const arguments* p_arguments,
+            std::size_t p_count,
+            parse_result* p_results,
+            const context& p_context = {}) const;
+        void parse_batch(
+            const std::vector<arguments>& p_arguments,
+            std::vector<parse_result>& p_results,
+            const context& p_context = {}) const;
+
+    private:
+
+        friend class impl::name_index;
+        friend class impl::detached_parameters_schema;
+
+        const std::string* indexed_name(impl::name_kind p_kind, std::size_t p_item, std::size_t p_alias) const;
+
+        std::size_t allocate_slot(std::size_t p_size, std::size_t p_alignment);
+
+        std::vector<impl::detached_option> m_required_options = {};
+        std::vector<impl::detached_option> m_optional_options = {};
+        std::vector<impl::detached_option> m_flag_options = {};
+        std::vector<impl::detached_command> m_commands = {};
+        impl::name_index m_lookup_index = {};
+        std::size_t m_storage_size = 0;
+        std::size_t m_option_count = 0;
+
+    };
+
+
+    template<typename T>
+    struct static_option {
+        T& value;
+        std::string_view names = {};
+        std::string_view description = {};
+    };
+
+    template<typename T>
+    static_option(T&, std::string_view) -> static_option<T>;
+    template<typename T>
+    static_option(T&, std::string_view, std::string_view) -> static_option<T>;
+
+
+    template<typename T = bool>
+    struct static_option_flag {
+        T& value;
+        std::string_view names = {};
+        std::string_view description = {};
+    };
+
+    template<typename T>
+    static_option_flag(T&, std::string_view) -> static_option_flag<T>;
+    template<typename T>
+    static_option_flag(T&, std::string_view, std::string_view) -> static_option_flag<T>;
+
+
+    template<typename TCallback = int(*)(context&)>
+    struct static_command {
+        std::string_view names = {};
+        std::string_view description = {};
+        TCallback callback = {};
+    };
+
+    static_command(std::string_view) -> static_command<>;
+    static_command(std::string_view, std::string_view) -> static_command<>;
+    template<typename TCallback>
+    static_command(std::string_view, std::string_view, TCallback) -> static_command<TCallback>;
+
+
+    template<typename... TElements>
+    struct static_parameters {
+
+        std::tuple<TElements...> elements;
+        std::optional<error> error_handler = {};
+        std::optional<help> help_handler = {};
+
+        int parse(context& p_context) const;
+
+        parameters to_parameters() const;
+
+        static_parameters& set_error(const error& p_error);
+        static_parameters& set_error(error&& p_error);
+
+        static_parameters& set_help(const help& p_help);
+        static_parameters& set_help(help&& p_help);
+
+    };
+
+}
+
+
+namespace cppli::impl {
+
+    class parameters_schema {
+
+    public:
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        const std::optional<error>& error_handler;
+        const std::optional<help>& help_handler;
+
+        parameters_schema(const parameters& p_parameters, const command*& p_matched_command);
+
+        void set_current_parameter_group(context& p_context) const;
+
+        std::size_t required_option_count() const;
+        std::string_view required_option_name(std::size_t p_index) const;
+        bool set_required_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_flag(std::string_view p_name) const;
+        bool set_flag(std::size_t p_index) const;
+
+        std::size_t find_optional_option(std::string_view p_name) const;
+        std::string_view optional_option_name(std::size_t p_index) const;
+        bool set_optional_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_short_name(char p_name, name_kind& p_kind) const;
+
+        bool has_rest_arguments() const;
+        void set_rest_arguments(const argument_span& p_arguments) const;
+
+        bool has_commands() const;
+        std::size_t find_command(std::string_view p_name) const;
+        std::string_view command_name(std::size_t p_index) const;
+        int call_command(std::size_t p_index, context& p_context) const;
+
+        int call_help(const help& p_help, context& p_context) const;
+
+        bool has_abbreviations() const;
+        std::string_view expand_abbreviation(std::string_view p_name, bool& p_ambiguous) const;
+        std::size_t abbreviation_candidates(std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const;
+
+        bool has_environment() const;
+        std::string_view required_option_environment(std::size_t p_index) const;
+        template<typename TFunction>
+        void visit_environment(TFunction&& p_function) const;
+
+        template<typename TFunction>
+        void visit_names(TFunction&& p_function) const;
+
+    private:
+
+        static std::string_view first_name(const std::vector<std::string>& p_names);
+
+        const parameters& m_parameters;
+        const command*& m_matched_command;
+
+    };
+
+
+    class compiled_parameters_schema {
+
+    public:
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        const std::optional<error>& error_handler;
+        const std::optional<help>& help_handler;
+
+        explicit compiled_parameters_schema(const compiled_parameters& p_parameters);
+
+        void set_current_parameter_group(context& p_context) const;
+
+        std::size_t required_option_count() const;
+        std::string_view required_option_name(std::size_t p_index) const;
+        bool set_required_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_flag(std::string_view p_name) const;
+        bool set_flag(std::size_t p_index) const;
+
+        std::size_t find_optional_option(std::string_view p_name) const;
+        std::string_view optional_option_name(std::size_t p_index) const;
+        bool set_optional_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_short_name(char p_name, name_kind& p_kind) const;
+
+        bool has_rest_arguments() const;
+        void set_rest_arguments(const argument_span& p_arguments) const;
+
+        bool has_commands() const;
+        std::size_t find_command(std::string_view p_name) const;
+        std::string_view command_name(std::size_t p_index) const;
+        int call_command(std::size_t p_index, context& p_context) const;
+
+        int call_help(const help& p_help, context& p_context) const;
+
+        bool has_abbreviations() const;
+        std::string_view expand_abbreviation(std::string_view p_name, bool& p_ambiguous) const;
+        std::size_t abbreviation_candidates(std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const;
+
+        bool has_environment() const;
+        std::string_view required_option_environment(std::size_t p_index) const;
+        template<typename TFunction>
+        void visit_environment(TFunction&& p_function) const;
+
+        template<typename TFunction>
+        void visit_names(TFunction&& p_function) const;
+
+    private:
+
+        const compiled_parameters& m_parameters;
+
+    };
+
+    class detached_parameters_schema {
+
+    public:
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        const std::optional<error>& error_handler;
+        const std::optional<help>& help_handler;
+
+        detached_parameters_schema(const detached_parameters& p_parameters, parse_result& p_result);
+
+        void set_current_parameter_group(context& p_context) const;
+
+        std::size_t required_option_count() const;
+        std::string_view required_option_name(std::size_t p_index) const;
+        bool set_required_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_flag(std::string_view p_name) const;
+        bool set_flag(std::size_t p_index) const;
+
+        std::size_t find_optional_option(std::string_view p_name) const;
+        std::string_view optional_option_name(std::size_t p_index) const;
+        bool set_optional_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_short_name(char p_name, name_kind& p_kind) const;
+
+        bool has_rest_arguments() const;
+        void set_rest_arguments(const argument_span& p_arguments) const;
+
+        bool has_commands() const;
+        std::size_t find_command(std::string_view p_name) const;
+        std::string_view command_name(std::size_t p_index) const;
+        int call_command(std::size_t p_index, context& p_context) const;
+
+        int call_help(const help& p_help, context& p_context) const;
+
+        bool has_abbreviations() const;
+        std::string_view expand_abbreviation(std::string_view p_name, bool& p_ambiguous) const;
+        std::size_t abbreviation_candidates(std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const;
+
+        bool has_environment() const;
+        std::string_view required_option_environment(std::size_t p_index) const;
+        template<typename TFunction>
+        void visit_environment(TFunction&& p_function) const;
+
+        template<typename TFunction>
+        void visit_names(TFunction&& p_function) const;
+
+    private:
+
+        bool set_option(const detached_option& p_option, std::string_view p_value) const;
+
+        const detached_parameters& m_parameters;
+        parse_result& m_result;
+
+    };
+
+    template<typename... TElements>
+    class static_parameters_schema {
+
+    public:
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        const std::optional<error>& error_handler;
+        const std::optional<help>& help_handler;
+
+        explicit static_parameters_schema(const static_parameters<TElements...>& p_parameters);
+
+        void set_current_parameter_group(context& p_context) const;
+
+        constexpr std::size_t required_option_count() const;
+        std::string_view required_option_name(std::size_t p_index) const;
+        bool set_required_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_flag(std::string_view p_name) const;
+        bool set_flag(std::size_t p_index) const;
+
+        std::size_t find_optional_option(std::string_view p_name) const;
+        std::string_view optional_option_name(std::size_t p_index) const;
+        bool set_optional_option(std::size_t p_index, std::string_view p_value) const;
+
+        std::size_t find_short_name(char p_name, name_kind& p_kind) const;
+
+        constexpr bool has_rest_arguments() const;
+        void set_rest_arguments(const argument_span& p_arguments) const;
+
+        constexpr bool has_commands() const;
+        std::size_t find_command(std::string_view p_name) const;
+        std::string_view command_name(std::size_t p_index) const;
+        int call_command(std::size_t p_index, context& p_context) const;
+
+        int call_help(const help& p_help, context& p_context) const;
+
+        constexpr bool has_abbreviations() const;
+        std::string_view expand_abbreviation(std::string_view p_name, bool& p_ambiguous) const;
+        std::size_t abbreviation_candidates(std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const;
+
+        constexpr bool has_environment() const;
+        std::string_view required_option_environment(std::size_t p_index) const;
+        template<typename TFunction>
+        void visit_environment(TFunction&& p_function) const;
+
+        template<typename TFunction>
+        void visit_names(TFunction&& p_function) const;
+
+    private:
+
+        template<template<typename> typename TKind>
+        std::size_t find_element(std::string_view p_name) const;
+
+        template<template<typename> typename TKind>
+        std::string_view element_name(std::size_t p_index) const;
+
+        const static_parameters<TElements...>& m_parameters;
+
+    };
+
+}
+
+// Implementations.
+namespace cppli::impl {
+
+    inline std::string_view parse_program_name(std::string_view path) {
+        const auto path_view = path;
+
+        const auto last_dir_pos = path_view.find_last_of("/\\");
+        const auto program_offset = last_dir_pos != std::string_view::npos ? last_dir_pos + 1 : 0;
+        const auto program_exe_len = path_view.size() - program_offset;
+
+        const auto program_exe_view = std::string_view{ path_view.data() + program_offset, program_exe_len };
+
+        const auto last_ext_pos = program_exe_view.find_last_of('.');
+        const auto program_len = last_ext_pos != std::string_view::npos ? last_ext_pos : program_exe_view.size();
+
+        return std::string_view{ program_exe_view.data(), program_len };
+    }
+
+    inline bool handle_first_arg_is_path(context& p_context) {
+        // Only the first argument of the whole parse is the path, nested parameters continue past it.
+        if (p_context.first_arg_is_path && p_context.arg_index == 0) {
+            if (p_context.argc <= 0) {
+                return false;
+            }
                 
-            auto program_name = impl::parse_program_name(p_context.argv[0]);
+            auto program_name = impl::parse_program_name(p_context.current_arg());
             if (!program_name.empty()) {
                 p_context.current_path.emplace_back(program_name);
             }
-            p_context.move_to_next_arg();
+            p_context.move_to_next_arg();
+        }
+        return true;
+    }
+
+    // Inplace function.
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>::inplace_function(std::nullptr_t) noexcept
+    {}
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    template<typename TCallable, typename>
+    inline inplace_function<TReturn(TArgs...), VCapacity>::inplace_function(TCallable&& p_callable) {
+        using callable_type = std::decay_t<TCallable>;
+
+        static_assert(sizeof(callable_type) <= VCapacity,
+            "Callable is too large for the inline storage of cppli callbacks, capture less or pass it through std::ref.");
+        static_assert(alignof(callable_type) <= alignof(std::max_align_t),
+            "Callable is over-aligned for the inline storage of cppli callbacks.");
+        static_assert(std::is_copy_constructible_v<callable_type>,
+            "Callable of cppli callbacks must be copy constructible.");
+
+        if constexpr (std::is_pointer_v<callable_type> || std::is_member_pointer_v<callable_type>) {
+            if (p_callable == nullptr) {
+                return;
+            }
+        }
+
+        ::new (static_cast<void*>(m_storage)) callable_type(std::forward<TCallable>(p_callable));
+        m_vtable = get_vtable<callable_type>();
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>::inplace_function(const inplace_function& p_other) :
+        m_vtable(p_other.m_vtable)
+    {
+        if (m_vtable) {
+            m_vtable->copy(m_storage, p_other.m_storage);
+        }
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>::inplace_function(inplace_function&& p_other) noexcept :
+        m_vtable(p_other.m_vtable)
+    {
+        if (m_vtable) {
+            m_vtable->move(m_storage, p_other.m_storage);
+            p_other.reset();
+        }
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>::~inplace_function() {
+        reset();
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>& inplace_function<TReturn(TArgs...), VCapacity>::operator = (const inplace_function& p_other) {
+        if (this != &p_other) {
+            reset();
+            if (p_other.m_vtable) {
+                p_other.m_vtable->copy(m_storage, p_other.m_storage);
+                m_vtable = p_other.m_vtable;
+            }
+        }
+        return *this;
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>& inplace_function<TReturn(TArgs...), VCapacity>::operator = (inplace_function&& p_other) noexcept {
+        if (this != &p_other) {
+            reset();
+            if (p_other.m_vtable) {
+                p_other.m_vtable->move(m_storage, p_other.m_storage);
+                m_vtable = p_other.m_vtable;
+                p_other.reset();
+            }
+        }
+        return *this;
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>& inplace_function<TReturn(TArgs...), VCapacity>::operator = (std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline inplace_function<TReturn(TArgs...), VCapacity>::operator bool() const noexcept {
+        return m_vtable != nullptr;
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline TReturn inplace_function<TReturn(TArgs...), VCapacity>::operator()(TArgs... p_args) const {
+        return m_vtable->invoke(m_storage, std::forward<TArgs>(p_args)...);
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    template<typename TCallable>
+    inline const typename inplace_function<TReturn(TArgs...), VCapacity>::vtable* inplace_function<TReturn(TArgs...), VCapacity>::get_vtable() {
+        static constexpr vtable callable_vtable = {
+            [](void* p_storage, TArgs&&... p_args) -> TReturn {
+                return static_cast<TReturn>(std::invoke(*static_cast<TCallable*>(p_storage), std::forward<TArgs>(p_args)...));
+            },
+            [](void* p_storage, const void* p_other) {
+                ::new (p_storage) TCallable(*static_cast<const TCallable*>(p_other));
+            },
+            [](void* p_storage, void* p_other) noexcept {
+                ::new (p_storage) TCallable(std::move(*static_cast<TCallable*>(p_other)));
+            },
+            [](void* p_storage) noexcept {
+                static_cast<TCallable*>(p_storage)->~TCallable();
+            }
+        };
+        return &callable_vtable;
+    }
+
+    template<typename TReturn, typename... TArgs, std::size_t VCapacity>
+    inline void inplace_function<TReturn(TArgs...), VCapacity>::reset() noexcept {
+        if (m_vtable) {
+            m_vtable->destroy(m_storage);
+            m_vtable = nullptr;
+        }
+    }
+
+    template<typename T>
+    inline const error* get_error_handler(const context& p_context, const T& p_other) {
+        return p_other.error_handler.has_value() ?
+            &p_other.error_handler.value() :
+            p_context.error_handler.has_value() ?
+                &p_context.error_handler.value() :
+                nullptr;
+    }
+
+    inline const error_callback* get_error_callback(const error* p_error) {
+        return p_error && p_error->callback ? &p_error->callback : nullptr;
+    }
+
+    template<typename T>
+    inline const help* get_help_handler(const context& p_context, const T& p_other) {
+        return p_other.help_handler.has_value() ?
+            &p_other.help_handler.value() :
+            p_context.help_handler.has_value() ?
+                &p_context.help_handler.value() :
+                nullptr;
+    }
+
+    template<typename T>
+    inline bool parse_value(T& p_value, std::string_view p_string) {
+        static_assert(!std::is_const_v<T>, "Option value cannot be const.");
+
+        using type = typename impl::raw_option_type_t<std::decay_t<T>>;
+
+        if constexpr (std::is_same_v<type, bool> == true) {
+            auto equals_lower = [p_string](std::string_view p_lower) {
+                return p_string.size() == p_lower.size() &&
+                    std::equal(p_string.begin(), p_string.end(), p_lower.begin(), [](const char p_lhs, const char p_rhs) {
+                        return std::tolower(static_cast<unsigned char>(p_lhs)) == p_rhs;
+                    });
+            };
+
+            if (equals_lower("true") || p_string == "1") {
+                p_value = true;
+                return true;
+            }
+            if (equals_lower("false") || p_string == "0") {
+                p_value = false;
+                return true;
+            }
+
+            return false;
+        }
+        else if constexpr (is_template_instance_v<type, std::vector> == true) {
+            // Repeated occurrences append, and each occurrence may hold comma separated values.
+            const auto previous_size = p_value.size();
+            const auto needed = previous_size + static_cast<std::size_t>(std::count(p_string.begin(), p_string.end(), ',')) + 1;
+            if (p_value.capacity() < needed) {
+                // Grows geometrically, since an exact reserve per occurrence makes repeated options quadratic.
+                p_value.reserve(std::max(needed, 2 * p_value.capacity()));
+            }
+
+            while (true) {
+                const auto delimiter = p_string.find(',');
+                auto element = typename type::value_type{};
+                if (!parse_value(element, p_string.substr(0, delimiter))) {
+                    p_value.erase(p_value.begin() + static_cast<std::ptrdiff_t>(previous_size), p_value.end());
+                    return false;
+                }
+                p_value.push_back(std::move(element));
+
+                if (delimiter == std::string_view::npos) {
+                    return true;
+                }
+                p_string.remove_prefix(delimiter + 1);
+            }
+        }
+        else if constexpr (std::is_integral_v<type> == true) {
+            type value{};
+            const auto result = parse_integer(value, p_string);
+            if (result) {
+                p_value = value;
+            }
+            return result;
+        }
+        else if constexpr (std::is_floating_point_v<type> == true) {
+            type value{};
+            const auto result = std::from_chars(p_string.data(), p_string.data() + p_string.size(), value).ec == std::errc();
+            if (result) {
+                p_value = value;
+            }
+            return result;
+        }
+        else if constexpr (std::is_same_v<type, byte_size> == true) {
+            auto value = byte_size{};
+            const auto result = parse_byte_size(value.bytes, p_string);
+            if (result) {
+                p_value = value;
+            }
+            return result;
+        }
+        else if constexpr (is_duration<type>::value == true) {
+            type value{};
+            const auto result = parse_duration(value, p_string);
+            if (result) {
+                p_value = value;
+            }
+            return result;
+        }
+        else {
+            p_value = p_string;
+            return true;
+        }
+    }
+
+    template<typename T>
+    inline bool parse_integer(T& p_value, std::string_view p_string) {
+        using unsigned_type = std::make_unsigned_t<T>;
+
+        auto negative = false;
+        if (!p_string.empty() && (p_string.front() == '-' || p_string.front() == '+')) {
+            negative = p_string.front() == '-';
+            p_string.remove_prefix(1);
+        }
+
+        auto base = 10;
+        if (p_string.size() > 2 && p_string[0] == '0') {
+            switch (p_string[1]) {
+                case 'x': case 'X': base = 16; break;
+                case 'o': case 'O': base = 8; break;
+                case 'b': case 'B': base = 2; break;
+                default: break;
+            }
+            if (base != 10) {
+                p_string.remove_prefix(2);
+            }
+        }
+
+        if (p_string.empty() || p_string.front() == '-' || p_string.front() == '+') {
+            return false;
+        }
+
+        auto magnitude = unsigned_type{};
+        const auto* end = p_string.data() + p_string.size();
+        const auto [ptr, ec] = std::from_chars(p_string.data(), end, magnitude, base);
+        if (ec != std::errc() || ptr != end) {
+            return false;
+        }
+
+        if constexpr (std::is_signed_v<T> == true) {
+            const auto max_magnitude = static_cast<unsigned_type>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+            if (magnitude > max_magnitude) {
+                return false;
+            }
+            if (negative) {
+                // Negate via magnitude - 1 so the minimum value does not overflow.
+                p_value = magnitude == 0 ? T{ 0 } : static_cast<T>(-static_cast<T>(magnitude - 1) - 1);
+            }
+            else {
+                p_value = static_cast<T>(magnitude);
+            }
+        }
+        else {
+            if (negative && magnitude != 0) {
+                return false;
+            }
+            p_value = static_cast<T>(magnitude);
+        }
+        return true;
+    }
+
+    inline bool parse_decimal(long double& p_value, std::string_view& p_string) {
+        if (p_string.empty() || p_string.front() == '+' ||
+            (p_string.front() != '-' && p_string.front() != '.' && !std::isdigit(static_cast<unsigned char>(p_string.front()))))
+        {
+            return false;
+        }
+
+        const auto [ptr, ec] = std::from_chars(p_string.data(), p_string.data() + p_string.size(), p_value, std::chars_format::fixed);
+        if (ec != std::errc() || !std::isfinite(p_value)) {
+            return false;
+        }
+        p_string.remove_prefix(static_cast<std::size_t>(ptr - p_string.data()));
+        return true;
+    }
+
+    inline bool parse_byte_size(std::uint64_t& p_value, std::string_view p_string) {
+        const auto digit_count = std::min(p_string.find_first_not_of("0123456789"), p_string.size());
+        const auto is_integer = digit_count > 0 && (digit_count == p_string.size() || p_string[digit_count] != '.');
+
+        auto integer_value = std::uint64_t{};
+        auto decimal_value = 0.0L;
+        auto suffix = p_string;
+        if (is_integer) {
+            if (std::from_chars(p_string.data(), p_string.data() + digit_count, integer_value).ec != std::errc()) {
+                return false;
+            }
+            suffix.remove_prefix(digit_count);
+        }
+        else if (!parse_decimal(decimal_value, suffix) || decimal_value < 0.0L) {
+            return false;
+        }
+
+        if (!suffix.empty() && suffix.back() == 'B') {
+            suffix.remove_suffix(1);
+        }
+        const auto binary = !suffix.empty() && suffix.back() == 'i';
+        if (binary) {
+            suffix.remove_suffix(1);
+        }
+        if (suffix.size() > 1 || (binary && suffix.empty())) {
+            return false;
+        }
+
+        auto exponent = 0;
+        if (!suffix.empty()) {
+            switch (suffix.front()) {
+                case 'k': case 'K': exponent = 1; break;
+                case 'M': exponent = 2; break;
+                case 'G': exponent = 3; break;
+                case 'T': exponent = 4; break;
+                default: return false;
+            }
+        }
+
+        auto multiplier = std::uint64_t{ 1 };
+        for (auto i = 0; i < exponent; ++i) {
+            multiplier *= binary ? std::uint64_t{ 1024 } : std::uint64_t{ 1000 };
+        }
+
+        if (is_integer) {
+            if (integer_value > std::numeric_limits<std::uint64_t>::max() / multiplier) {
+                return false;
+            }
+            p_value = integer_value * multiplier;
+            return true;
+        }
+
+        const auto bytes = std::round(decimal_value * static_cast<long double>(multiplier));
+        if (bytes >= static_cast<long double>(std::numeric_limits<std::uint64_t>::max())) {
+            return false;
+        }
+        p_value = static_cast<std::uint64_t>(bytes);
+        return true;
+    }
+
+    template<typename TRep, typename TPeriod>
+    inline bool parse_duration(std::chrono::duration<TRep, TPeriod>& p_value, std::string_view p_string) {
+        auto value = 0.0L;
+        auto suffix = p_string;
+        if (!parse_decimal(value, suffix)) {
+            return false;
+        }
+
+        // Seconds per unit of the suffix, as a ratio. No suffix means the unit of the target duration.
+        auto unit_num = static_cast<long double>(TPeriod::num);
+        auto unit_den = static_cast<long double>(TPeriod::den);
+        if (suffix == "ns") { unit_num = 1.0L; unit_den = 1000000000.0L; }
+        else if (suffix == "us") { unit_num = 1.0L; unit_den = 1000000.0L; }
+        else if (suffix == "ms") { unit_num = 1.0L; unit_den = 1000.0L; }
+        else if (suffix == "s") { unit_num = 1.0L; unit_den = 1.0L; }
+        else if (suffix == "m") { unit_num = 60.0L; unit_den = 1.0L; }
+        else if (suffix == "h") { unit_num = 3600.0L; unit_den = 1.0L; }
+        else if (!suffix.empty()) {
+            return false;
+        }
+
+        auto count = value * unit_num * static_cast<long double>(TPeriod::den) /
+            (unit_den * static_cast<long double>(TPeriod::num));
+
+        if constexpr (std::is_integral_v<TRep> == true) {
+            count = std::round(count);
+            if (count < static_cast<long double>(std::numeric_limits<TRep>::min()) ||
+                count >= static_cast<long double>(std::numeric_limits<TRep>::max()))
+            {
+                return false;
+            }
+        }
+        else {
+            if (std::fabs(count) > static_cast<long double>(std::numeric_limits<TRep>::max())) {
+                return false;
+            }
+        }
+
+        p_value = std::chrono::duration<TRep, TPeriod>{ static_cast<TRep>(count) };
+        return true;
+    }
+
+    template<typename T>
+    inline void set_flag_value(T& p_value) {
+        static_assert(!std::is_const_v<T>, "Option value cannot be const.");
+
+        using type = typename impl::raw_option_type_t<std::decay_t<T>>;
+
+        p_value = static_cast<type>(true);
+    }
+
+    template<typename T>
+    inline bool set_detached_value(void* p_slot, std::string_view p_value) {
+        auto value = T{};
+        if (!parse_value(value, p_value)) {
+            return false;
+        }
+        std::memcpy(p_slot, &value, sizeof(T));
+        return true;
+    }
+
+    template<typename T>
+    inline set_value_callback create_set_value_callback(T& p_value) {
+        return [&p_value](std::string_view string) mutable {
+            return parse_value(p_value, string);
+        };
+    }
+
+    template<typename T>
+    inline set_flag_callback create_set_flag_callback(T& p_value) {
+        return [&p_value]() mutable {
+            set_flag_value(p_value);
+        };
+    }
+
+    inline std::uint32_t hash_name(std::string_view p_name) {
+        auto hash = std::uint32_t{ 2166136261u };
+        for (const auto c : p_name) {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= std::uint32_t{ 16777619u };
+        }
+        return hash;
+    }
+
+    template<typename T>
+    inline const T* find_by_name(const std::vector<T>& p_items, std::string_view p_name) {
+        for (auto& item : p_items) {
+            if (item.has_name(p_name)) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+
+    template<template<typename> typename TKind, typename... TElements>
+    constexpr std::size_t count_static_elements() {
+        return (std::size_t{ TKind<TElements>::value ? 1u : 0u } + ... + std::size_t{ 0 });
+    }
+
+    template<template<typename> typename TKind, typename TTuple, typename TFunction>
+    inline bool visit_static_elements(const TTuple& p_elements, TFunction&& p_function) {
+        return std::apply([&](const auto&... p_element) {
+            std::size_t kind_index = 0;
+
+            auto visit = [&](const auto& p_current) {
+                if constexpr (TKind<std::decay_t<decltype(p_current)>>::value) {
+                    return p_function(p_current, kind_index++);
+                }
+                else {
+                    return false;
+                }
+            };
+
+            return (visit(p_element) || ...);
+        }, p_elements);
+    }
+
+    constexpr bool static_names_contain(std::string_view p_names, std::string_view p_name) {
+        std::size_t begin = 0;
+        while (begin <= p_names.size()) {
+            const auto end = p_names.find('|', begin);
+            const auto length = end == std::string_view::npos ? p_names.size() - begin : end - begin;
+            if (length == p_name.size() && length != 0 && p_names.substr(begin, length) == p_name) {
+                return true;
+            }
+            if (end == std::string_view::npos) {
+                break;
+            }
+            begin = end + 1;
+        }
+        return false;
+    }
+
+    constexpr std::string_view static_first_name(std::string_view p_names) {
+        const auto name = p_names.substr(0, p_names.find('|'));
+        return !name.empty() ? name : std::string_view{ "opt" };
+    }
+
+    inline std::vector<std::string> split_static_names(std::string_view p_names) {
+        auto names = std::vector<std::string>{};
+        std::size_t begin = 0;
+        while (begin < p_names.size()) {
+            const auto end = std::min(p_names.find('|', begin), p_names.size());
+            if (end > begin) {
+                names.emplace_back(p_names.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        return names;
+    }
+
+
+    // Help cache.
+    inline help_cache::help_cache(const help_cache&) noexcept
+    {}
+
+    inline help_cache& help_cache::operator = (const help_cache&) noexcept {
+        clear();
+        return *this;
+    }
+
+    inline std::shared_ptr<const std::string> help_cache::get(const parameters& p_parameters, const help* p_help) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_body || m_body_generation != m_generation || m_body_help != p_help) {
+            m_body = std::make_shared<const std::string>(render(p_parameters, p_help));
+            m_body_generation = m_generation;
+            m_body_help = p_help;
+        }
+        return m_body;
+    }
+
+    inline void help_cache::invalidate() noexcept {
+        // Bumped by the mutators of parameters, which are not called while it is parsed.
+        ++m_generation;
+    }
+
+    inline void help_cache::clear() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body.reset();
+        m_body_help = nullptr;
+    }
+
+    inline std::string help_cache::render(const parameters& p_parameters, const help* p_help) {
+        auto result = std::string{};
+
+        const size_t pre_option_count =
+            p_parameters.required_options.size() +
+            p_parameters.optional_options.size() +
+            p_parameters.flag_options.size() +
+            ((p_help && p_help->has_names()) ? size_t{ 1 } : size_t{ 0 });
+
+        const size_t pre_command_count = p_parameters.commands.size();
+
+        if (pre_option_count == 0 && pre_command_count == 0 && !p_parameters.rest_handler.has_value()) {
+            return result;
+        }
+
+        auto joined_names_size = [](const std::vector<std::string>& p_names) {
+            if (p_names.empty()) {
+                return size_t{ 0 };
+            }
+            auto size = p_names.front().size();
+            for (auto it = std::next(p_names.begin()); it != p_names.end(); ++it) {
+                size += !it->empty() ? it->size() + 1 : size_t{ 0 };
+            }
+            return size;
+        };
+
+        auto append_joined_names = [](std::string& p_result, const std::vector<std::string>& p_names) {
+            p_result += p_names.front();
+            for (auto it = std::next(p_names.begin()); it != p_names.end(); ++it) {
+                if (!it->empty()) {
+                    p_result += '|';
+                    p_result += *it;
+                }
+            }
+        };
+
+        const bool help_is_command = p_help && pre_command_count > 0;
+        size_t option_row_count = 0;
+        size_t command_row_count = 0;
+        size_t min_command_column = 0;
+        size_t total_size = 64 + (p_parameters.rest_handler.has_value() ? p_parameters.rest_handler->name.size() : size_t{ 0 });
+
+        auto measure_row = [&](size_t& p_row_count, const std::vector<std::string>& p_names, const std::string& p_description) {
+            const auto name_size = joined_names_size(p_names);
+            if (name_size == 0) {
+                return;
+            }
+            ++p_row_count;
+            min_command_column = std::max(min_command_column, name_size);
+            total_size += name_size + p_description.size() + 3;
+        };
+
+        if (p_help) {
+            measure_row(help_is_command ? command_row_count : option_row_count, p_help->names, p_help->description);
+        }
+        for (const auto& option : p_parameters.required_options) {
+            measure_row(option_row_count, option.names, option.description);
+            total_size += option.has_names() ? option.names.front().size() + 3 : size_t{ 0 };
+        }
+        for (const auto& option : p_parameters.optional_options) {
+            measure_row(option_row_count, option.names, option.description);
+        }
+        for (const auto& option : p_parameters.flag_options) {
+            measure_row(option_row_count, option.names, option.description);
+        }
+        for (const auto& command : p_parameters.commands) {
+            measure_row(command_row_count, command.names, command.description);
+        }
+
+        result.reserve(total_size + (option_row_count + command_row_count) * (min_command_column + 6));
+
+        for (const auto& option : p_parameters.required_options) {
+            if (option.has_names()) {
+                result += " <";
+                result += option.names.front();
+                result += '>';
+            }
+        }
+        if (option_row_count > 0) {
+            result += " [options]";
+        }
+        if (command_row_count > 0) {
+            result += " [command] [command-options]";
+        }
+        if (p_parameters.rest_handler.has_value()) {
+            result += " [--] <";
+            result += p_parameters.rest_handler->name;
+            result += ">...";
+        }
+        result += '\n';
+
+        auto append_row = [&](const std::vector<std::string>& p_names, const std::string& p_description) {
+            const auto name_size = joined_names_size(p_names);
+            if (name_size == 0) {
+                return;
+            }
+            result += "  ";
+            append_joined_names(result, p_names);
+            result.append(min_command_column - name_size + size_t{ 6 }, ' ');
+            result += p_description;
+            result += '\n';
+        };
+
+        if (option_row_count > 0) {
+            result += "\nOptions:\n";
+            if (p_help && !help_is_command) {
+                append_row(p_help->names, p_help->description);
+            }
+            for (const auto& option : p_parameters.required_options) {
+                append_row(option.names, option.description);
+            }
+            for (const auto& option : p_parameters.optional_options) {
+                append_row(option.names, option.description);
+            }
+            for (const auto& option : p_parameters.flag_options) {
+                append_row(option.names, option.description);
+            }
+        }
+
+        if (command_row_count > 0) {
+            result += "\nCommands:\n";
+            if (help_is_command) {
+                append_row(p_help->names, p_help->description);
+            }
+            for (const auto& command : p_parameters.commands) {
+                append_row(command.names, command.description);
+            }
+        }
+
+        return result;
+    }
+
+    // Mapped file.
+    inline mapped_file::~mapped_file() {
+        close();
+    }
+
+    inline bool mapped_file::open(const std::string& p_path) {
+        close();
+
+#if defined(_WIN32)
+        std::FILE* file = nullptr;
+        if (::fopen_s(&file, p_path.c_str(), "rb") != 0 || file == nullptr) {
+            return false;
+        }
+        // The 64-bit position functions report -1 on failure, and sizes past 2 GiB, where ftell does not.
+        const auto size = ::_fseeki64(file, 0, SEEK_END) == 0 ? ::_ftelli64(file) : -1;
+        if (size < 0 || ::_fseeki64(file, 0, SEEK_SET) != 0) {
+            std::fclose(file);
+            return false;
+        }
+        m_size = static_cast<std::size_t>(size);
+        m_buffer = std::make_unique<char[]>(m_size > 0 ? m_size : 1);
+        const auto read_size = std::fread(m_buffer.get(), 1, m_size, file);
+        std::fclose(file);
+        if (read_size != m_size) {
+            close();
+            return false;
+        }
+        return true;
+#else
+        const auto fd = ::open(p_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat file_stat = {};
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        m_size = static_cast<std::size_t>(file_stat.st_size);
+        if (m_size > 0) {
+            m_mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m_mapping == MAP_FAILED) {
+                m_mapping = nullptr;
+                m_size = 0;
+                ::close(fd);
+                return false;
+            }
+        }
+
+        ::close(fd);
+        return true;
+#endif
+    }
+
+    inline void mapped_file::close() {
+#if defined(_WIN32)
+        m_buffer.reset();
+#else
+        if (m_mapping != nullptr) {
+            ::munmap(m_mapping, m_size);
+            m_mapping = nullptr;
+        }
+#endif
+        m_size = 0;
+    }
+
+    inline std::string_view mapped_file::content() const {
+#if defined(_WIN32)
+        return m_buffer ? std::string_view{ m_buffer.get(), m_size } : std::string_view{};
+#else
+        return m_mapping != nullptr ? std::string_view{ static_cast<const char*>(m_mapping), m_size } : std::string_view{};
+#endif
+    }
+
+    inline bool write_fd(int p_fd, std::string_view p_first, std::string_view p_second, std::string_view p_third) {
+#if defined(_WIN32)
+        auto buffer = std::string{};
+        buffer.reserve(p_first.size() + p_second.size() + p_third.size());
+        buffer.append(p_first).append(p_second).append(p_third);
+        return _write(p_fd, buffer.data(), static_cast<unsigned int>(buffer.size())) == static_cast<int>(buffer.size());
+#else
+        auto buffers = std::array<iovec, 3>{
+            iovec{ const_cast<char*>(p_first.data()), p_first.size() },
+            iovec{ const_cast<char*>(p_second.data()), p_second.size() },
+            iovec{ const_cast<char*>(p_third.data()), p_third.size() } };
+
+        auto* current = buffers.data();
+        auto remaining = static_cast<int>(buffers.size());
+        while (remaining > 0) {
+            const auto written = ::writev(p_fd, current, remaining);
+            if (written < 0) {
+                return false;
+            }
+
+            auto consumed = static_cast<std::size_t>(written);
+            while (remaining > 0 && consumed >= current->iov_len) {
+                consumed -= current->iov_len;
+                ++current;
+                --remaining;
+            }
+            if (remaining > 0) {
+                current->iov_base = static_cast<char*>(current->iov_base) + consumed;
+                current->iov_len -= consumed;
+            }
+        }
+        return true;
+#endif
+    }
+
+
+    // Abbreviation index.
+    inline abbreviation_index::abbreviation_index(const abbreviation_index&) noexcept
+    {}
+
+    inline abbreviation_index& abbreviation_index::operator = (const abbreviation_index&) noexcept {
+        clear();
+        return *this;
+    }
+
+    inline std::string_view abbreviation_index::expand(const parameters& p_parameters, std::string_view p_name, bool& p_ambiguous) const {
+        const auto current_table = get(p_parameters);
+        const auto [first, last] = find_prefix(*current_table, p_name);
+        if (first == last) {
+            return p_name;
+        }
+
+        // Aliases of one item share the change count, so the range is unambiguous if both ends agree.
+        if (first->item_changes != (last - 1)->item_changes) {
+            p_ambiguous = true;
+            return p_name;
+        }
+        return first->name;
+    }
+
+    inline std::size_t abbreviation_index::candidates(const parameters& p_parameters, std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const {
+        const auto current_table = get(p_parameters);
+        const auto [first, last] = find_prefix(*current_table, p_prefix);
+
+        auto items = std::vector<std::uint32_t>{};
+        for (auto it = first; it != last && items.size() < p_max_count; ++it) {
+            if (std::find(items.begin(), items.end(), it->item) == items.end()) {
+                p_output[items.size()] = it->name;
+                items.push_back(it->item);
+            }
+        }
+        return items.size();
+    }
+
+    inline void abbreviation_index::clear() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_table.reset();
+    }
+
+    inline std::array<std::size_t, 3> abbreviation_index::item_counts(const parameters& p_parameters) {
+        return {
+            p_parameters.flag_options.size(),
+            p_parameters.optional_options.size(),
+            p_parameters.commands.size() };
+    }
+
+    inline std::shared_ptr<const abbreviation_index::table> abbreviation_index::build(const parameters& p_parameters) {
+        auto result = std::make_shared<table>();
+        result->item_counts = item_counts(p_parameters);
+
+        std::uint32_t item = 0;
+        auto add_items = [&](const auto& p_items) {
+            for (const auto& current_item : p_items) {
+                for (const auto& name : current_item.names) {
+                    if (!name.empty()) {
+                        result->entries.push_back(entry{ name, item, 0 });
+                    }
+                }
+                ++item;
+            }
+        };
+        add_items(p_parameters.flag_options);
+        add_items(p_parameters.optional_options);
+        add_items(p_parameters.commands);
+
+        std::sort(result->entries.begin(), result->entries.end(), [](const entry& p_lhs, const entry& p_rhs) {
+            return p_lhs.name < p_rhs.name;
+        });
+        for (std::size_t i = 1; i < result->entries.size(); ++i) {
+            auto& current_entry = result->entries[i];
+            const auto& previous_entry = result->entries[i - 1];
+            current_entry.item_changes = previous_entry.item_changes + (current_entry.item != previous_entry.item ? 1 : 0);
+        }
+
+        return result;
+    }
+
+    inline abbreviation_index::entry_range abbreviation_index::find_prefix(const table& p_table, std::string_view p_prefix) {
+        const auto* begin = p_table.entries.data();
+        const auto* end = begin + p_table.entries.size();
+        if (p_prefix.empty()) {
+            return { end, end };
+        }
+
+        const auto* first = std::lower_bound(begin, end, p_prefix, [](const entry& p_entry, std::string_view p_value) {
+            return p_entry.name < p_value;
+        });
+        const auto* last = std::partition_point(first, end, [p_prefix](const entry& p_entry) {
+            return p_entry.name.compare(0, p_prefix.size(), p_prefix) == 0;
+        });
+        return { first, last };
+    }
+
+    inline std::shared_ptr<const abbreviation_index::table> abbreviation_index::get(const parameters& p_parameters) const {
+        const auto current_item_counts = item_counts(p_parameters);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_table || m_table->item_counts != current_item_counts) {
+            m_table = build(p_parameters);
+        }
+        return m_table;
+    }
+
+
+    // Resource allocator.
+    template<typename T>
+    inline resource_allocator<T>::resource_allocator() noexcept :
+        m_resource(std::pmr::get_default_resource())
+    {}
+
+    template<typename T>
+    inline resource_allocator<T>::resource_allocator(std::pmr::memory_resource* p_resource) noexcept :
+        m_resource(p_resource != nullptr ? p_resource : std::pmr::get_default_resource())
+    {}
+
+    template<typename T>
+    template<typename U>
+    inline resource_allocator<T>::resource_allocator(const resource_allocator<U>& p_other) noexcept :
+        m_resource(p_other.resource())
+    {}
+
+    template<typename T>
+    inline T* resource_allocator<T>::allocate(std::size_t p_count) {
+        return static_cast<T*>(m_resource->allocate(p_count * sizeof(T), alignof(T)));
+    }
+
+    template<typename T>
+    inline void resource_allocator<T>::deallocate(T* p_pointer, std::size_t p_count) noexcept {
+        m_resource->deallocate(p_pointer, p_count * sizeof(T), alignof(T));
+    }
+
+    template<typename T>
+    inline std::pmr::memory_resource* resource_allocator<T>::resource() const noexcept {
+        return m_resource;
+    }
+
+    template<typename T>
+    template<typename U>
+    inline bool resource_allocator<T>::operator == (const resource_allocator<U>& p_other) const noexcept {
+        return *m_resource == *p_other.resource();
+    }
+
+    template<typename T>
+    template<typename U>
+    inline bool resource_allocator<T>::operator != (const resource_allocator<U>& p_other) const noexcept {
+        return !(*this == p_other);
+    }
+
+
+    // Environment index.
+    inline void environment_index::clear() {
+        m_built = false;
+    }
+
+    inline void environment_index::set_memory_resource(std::pmr::memory_resource* p_resource) {
+        m_slots = resource_vector<slot>(p_resource);
+        m_built = false;
+    }
+
+    inline std::optional<std::string_view> environment_index::find(char** p_environment, std::string_view p_name) {
+        if (!m_built) {
+            build(p_environment);
+        }
+        if (m_slots.empty()) {
+            return std::nullopt;
+        }
+
+        const auto mask = m_slots.size() - 1;
+        for (auto position = hash_name(p_name) & mask; !m_slots[position].name.empty(); position = (position + 1) & mask) {
+            if (m_slots[position].name == p_name) {
+                return m_slots[position].value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    inline void environment_index::build(char** p_environment) {
+#if defined(_WIN32)
+        auto** entries = p_environment != nullptr ? p_environment : _environ;
+#else
+        auto** entries = p_environment != nullptr ? p_environment : environ;
+#endif
+        m_built = true;
+
+        std::size_t count = 0;
+        for (auto** entry = entries; entries != nullptr && *entry != nullptr; ++entry) {
+            ++count;
+        }
+
+        // Keeps the load factor at or below one half, the capacity is kept between parses.
+        auto size = std::size_t{ 16 };
+        while (size < count * 2) {
+            size *= 2;
+        }
+        m_slots.assign(size, slot{});
+
+        const auto mask = size - 1;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto variable = std::string_view{ entries[i] };
+            const auto separator = variable.find('=');
+            const auto name = variable.substr(0, separator);
+            if (separator == std::string_view::npos || name.empty()) {
+                continue;
+            }
+
+            // The first definition of a name wins, like getenv.
+            auto position = hash_name(name) & mask;
+            while (!m_slots[position].name.empty() && m_slots[position].name != name) {
+                position = (position + 1) & mask;
+            }
+            if (m_slots[position].name.empty()) {
+                m_slots[position] = slot{ name, variable.substr(separator + 1) };
+            }
+        }
+    }
+
+
+    // Option marks.
+    inline option_marks::option_marks(std::pmr::memory_resource* p_resource) :
+        m_overflow(p_resource)
+    {}
+
+    inline void option_marks::mark(name_kind p_kind, std::size_t p_index) {
+        // Marks of the first options are kept inline, later ones spill into the memory resource.
+        const auto position = bit_position(p_kind, p_index);
+        if (position < inline_capacity) {
+            m_inline[position / 64] |= std::uint64_t{ 1 } << (position % 64);
+            return;
+        }
+        const auto word = (position - inline_capacity) / 64;
+        if (m_overflow.size() <= word) {
+            m_overflow.resize(word + 1, 0);
+        }
+        m_overflow[word] |= std::uint64_t{ 1 } << (position % 64);
+    }
+
+    inline bool option_marks::is_marked(name_kind p_kind, std::size_t p_index) const {
+        const auto position = bit_position(p_kind, p_index);
+        if (position < inline_capacity) {
+            return (m_inline[position / 64] >> (position % 64)) & 1;
+        }
+        const auto word = (position - inline_capacity) / 64;
+        return word < m_overflow.size() && ((m_overflow[word] >> (position % 64)) & 1);
+    }
+
+    inline std::size_t option_marks::bit_position(name_kind p_kind, std::size_t p_index) {
+        return 2 * p_index + (p_kind == name_kind::flag ? 0 : 1);
+    }
+
+
+    // Name index.
+    inline void short_name_table::clear() {
+        m_entries = {};
+    }
+
+    inline void short_name_table::add(name_kind p_kind, std::size_t p_item, std::string_view p_name) {
+        if ((p_kind != name_kind::flag && p_kind != name_kind::optional) ||
+            p_name.size() != 2 || p_name[0] != '-' || p_name[1] == '-' || static_cast<unsigned char>(p_name[1]) >= 128)
+        {
+            return;
+        }
+
+        // Flags are looked up before optional options, as for whole names.
+        auto& current = m_entries[static_cast<unsigned char>(p_name[1])];
+        if (!current.used || (current.kind == name_kind::optional && p_kind == name_kind::flag)) {
+            current = entry{ static_cast<std::uint32_t>(p_item), p_kind, true };
+        }
+    }
+
+    inline std::size_t short_name_table::find(char p_name, name_kind& p_kind) const {
+        const auto position = static_cast<unsigned char>(p_name);
+        if (position >= 128 || !m_entries[position].used) {
+            return npos;
+        }
+        p_kind = m_entries[position].kind;
+        return m_entries[position].item;
+    }
+
+    inline void name_index::clear() {
+        // Keeps the table size, so a rebuild does not regrow it.
+        for (auto& current_slot : m_slots) {
+            current_slot.used = false;
+        }
+        m_used = 0;
+        m_item_counts = {};
+        m_short_names.clear();
+    }
+
+    inline bool name_index::covers(name_kind p_kind, std::size_t p_item_count) const {
+        return m_item_counts[static_cast<std::size_t>(p_kind)] == p_item_count;
+    }
+
+    template<typename TOwner>
+    inline void name_index::add_item(name_kind p_kind, const std::vector<std::string>& p_names, const TOwner& p_owner) {
+        const auto item = m_item_counts[static_cast<std::size_t>(p_kind)]++;
+
+        for (std::size_t alias = 0; alias < p_names.size(); ++alias) {
+            const auto& name = p_names[alias];
+            if (find(p_kind, name, p_owner) != npos) {
+                continue; // First item with a given name wins, same as a linear scan.
+            }
+
+            if ((m_used + 1) * 2 > m_slots.size()) {
+                grow();
+            }
+
+            const auto hash = hash_name(name);
+            const auto mask = m_slots.size() - 1;
+            auto position = start_position(p_kind, hash, mask);
+            while (m_slots[position].used) {
+                position = (position + 1) & mask;
+            }
+
+            m_slots[position] = slot{
+                hash,
+                static_cast<std::uint32_t>(item),
+                static_cast<std::uint16_t>(alias),
+                p_kind,
+                true };
+            ++m_used;
+            m_short_names.add(p_kind, item, name);
+        }
+    }
+
+    template<typename TOwner>
+    inline std::size_t name_index::find(name_kind p_kind, std::string_view p_name, const TOwner& p_owner) const {
+        if (m_used == 0) {
+            return npos;
+        }
+
+        const auto hash = hash_name(p_name);
+        const auto mask = m_slots.size() - 1;
+        auto position = start_position(p_kind, hash, mask);
+
+        while (m_slots[position].used) {
+            const auto& current = m_slots[position];
+            if (current.hash == hash && current.kind == p_kind) {
+                const std::string* name = p_owner.indexed_name(p_kind, current.item, current.alias);
+                if (name != nullptr && *name == p_name) {
+                    return current.item;
+                }
+            }
+            position = (position + 1) & mask;
+        }
+
+        return npos;
+    }
+
+    inline std::size_t name_index::find_short(char p_name, name_kind& p_kind) const {
+        return m_short_names.find(p_name, p_kind);
+    }
+
+    inline std::size_t name_index::start_position(name_kind p_kind, std::uint32_t p_hash, std::size_t p_mask) {
+        const auto kind_seed = static_cast<std::uint32_t>(p_kind) * std::uint32_t{ 0x9E3779B9u };
+        return static_cast<std::size_t>(p_hash ^ kind_seed) & p_mask;
+    }
+
+    inline void name_index::reserve(std::size_t p_name_count) {
+        auto new_size = m_slots.empty() ? size_t{ 16 } : m_slots.size();
+        while ((m_used + p_name_count) * 2 > new_size) {
+            new_size *= 2;
+        }
+        if (new_size != m_slots.size()) {
+            rehash(new_size);
+        }
+    }
+
+    inline void name_index::grow() {
+        rehash(m_slots.empty() ? size_t{ 16 } : m_slots.size() * 2);
+    }
+
+    inline void name_index::rehash(std::size_t p_size) {
+        auto old_slots = std::move(m_slots);
+        m_slots = std::vector<slot>(p_size, slot{ 0, 0, 0, name_kind::flag, false });
+
+        const auto mask = p_size - 1;
+        for (const auto& old_slot : old_slots) {
+            if (!old_slot.used) {
+                continue;
+            }
+            auto position = start_position(old_slot.kind, old_slot.hash, mask);
+            while (m_slots[position].used) {
+                position = (position + 1) & mask;
+            }
+            m_slots[position] = old_slot;
+        }
+    }
+
+
+    // Parameters schema.
+    inline parameters_schema::parameters_schema(const parameters& p_parameters, const command*& p_matched_command) :
+        error_handler(p_parameters.error_handler),
+        help_handler(p_parameters.help_handler),
+        m_parameters(p_parameters),
+        m_matched_command(p_matched_command)
+    {}
+
+    inline void parameters_schema::set_current_parameter_group(context& p_context) const {
+        p_context.current_parameter_group = m_parameters;
+    }
+
+    inline std::size_t parameters_schema::required_option_count() const {
+        return m_parameters.required_options.size();
+    }
+
+    inline std::string_view parameters_schema::required_option_name(std::size_t p_index) const {
+        return first_name(m_parameters.required_options[p_index].names);
+    }
+
+    inline bool parameters_schema::set_required_option(std::size_t p_index, std::string_view p_value) const {
+        return m_parameters.required_options[p_index].set_value(p_value);
+    }
+
+    inline std::size_t parameters_schema::find_flag(std::string_view p_name) const {
+        auto* flag = m_parameters.find_flag(p_name);
+        return flag != nullptr ? static_cast<std::size_t>(flag - m_parameters.flag_options.data()) : npos;
+    }
+
+    inline bool parameters_schema::set_flag(std::size_t p_index) const {
+        return m_parameters.flag_options[p_index].set_flag();
+    }
+
+    inline std::size_t parameters_schema::find_optional_option(std::string_view p_name) const {
+        auto* optional = m_parameters.find_optional(p_name);
+        return optional != nullptr ? static_cast<std::size_t>(optional - m_parameters.optional_options.data()) : npos;
+    }
+
+    inline std::string_view parameters_schema::optional_option_name(std::size_t p_index) const {
+        return first_name(m_parameters.optional_options[p_index].names);
+    }
+
+    inline bool parameters_schema::set_optional_option(std::size_t p_index, std::string_view p_value) const {
+        return m_parameters.optional_options[p_index].set_value(p_value);
+    }
+
+    inline std::size_t parameters_schema::find_short_name(char p_name, name_kind& p_kind) const {
+        const auto& lookup_index = m_parameters.m_lookup_index;
+        if (!lookup_index.covers(name_kind::flag, m_parameters.flag_options.size()) ||
+            !lookup_index.covers(name_kind::optional, m_parameters.optional_options.size()))
+        {
+            return find_short_name_by_lookup(*this, p_name, p_kind);
+        }
+        return lookup_index.find_short(p_name, p_kind);
+    }
+
+    inline bool parameters_schema::has_rest_arguments() const {
+        return m_parameters.rest_handler.has_value();
+    }
+
+    inline void parameters_schema::set_rest_arguments(const argument_span& p_arguments) const {
+        *m_parameters.rest_handler->value = p_arguments;
+    }
+
+    inline bool parameters_schema::has_commands() const {
+        return !m_parameters.commands.empty();
+    }
+
+    inline std::size_t parameters_schema::find_command(std::string_view p_name) const {
+        auto* command = m_parameters.find_command(p_name);
+        return command != nullptr ? static_cast<std::size_t>(command - m_parameters.commands.data()) : npos;
+    }
+
+    inline std::string_view parameters_schema::command_name(std::size_t p_index) const {
+        return first_name(m_parameters.commands[p_index].names);
+    }
+
+    inline int parameters_schema::call_command(std::size_t p_index, context& p_context) const {
+        const auto& command = m_parameters.commands[p_index];
+        m_matched_command = &command;
+
+        // Child parameters are parsed by parse_command_tree, which calls the callback once the child group is done.
+        if (command.child_parameters) {
+            return parse_codes::successful;
+        }
+        return command.callback ? command.callback(p_context) : parse_codes::successful;
+    }
+
+    inline int parameters_schema::call_help(const help& p_help, context& p_context) const {
+        return p_help.callback(p_context);
+    }
+
+    inline std::string_view parameters_schema::first_name(const std::vector<std::string>& p_names) {
+        return !p_names.empty() ? std::string_view{ p_names.front() } : std::string_view{ "opt" };
+    }
+
+
+    inline bool parameters_schema::has_abbreviations() const {
+        return m_parameters.allow_abbreviations;
+    }
+
+    inline std::string_view parameters_schema::expand_abbreviation(std::string_view p_name, bool& p_ambiguous) const {
+        if (m_parameters.find_flag(p_name) != nullptr ||
+            m_parameters.find_optional(p_name) != nullptr ||
+            m_parameters.find_command(p_name) != nullptr)
+        {
+            return p_name;
+        }
+        return m_parameters.m_abbreviation_index.expand(m_parameters, p_name, p_ambiguous);
+    }
+
+    inline std::size_t parameters_schema::abbreviation_candidates(std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const {
+        return m_parameters.m_abbreviation_index.candidates(m_parameters, p_prefix, p_output, p_max_count);
+    }
+
+    inline bool parameters_schema::has_environment() const {
+        // Required options are not in the environment items, they read the environment once the arguments run out.
+        return !m_parameters.m_environment_items.empty() ||
+            std::any_of(m_parameters.required_options.begin(), m_parameters.required_options.end(), [](const auto& p_option) {
+                return !p_option.environment.empty();
+            });
+    }
+
+    inline std::string_view parameters_schema::required_option_environment(std::size_t p_index) const {
+        return m_parameters.required_options[p_index].environment;
+    }
+
+    template<typename TFunction>
+    inline void parameters_schema::visit_environment(TFunction&& p_function) const {
+        for (const auto& [kind, index] : m_parameters.m_environment_items) {
+            if (kind == name_kind::flag) {
+                const auto& flag = m_parameters.flag_options[index];
+                p_function(kind, index, std::string_view{ flag.environment }, first_name(flag.names));
+            }
+            else if (kind == name_kind::optional) {
+                const auto& optional = m_parameters.optional_options[index];
+                p_function(kind, index, std::string_view{ optional.environment }, first_name(optional.names));
+            }
+        }
+    }
+
+    template<typename TFunction>
+    inline void parameters_schema::visit_names(TFunction&& p_function) const {
+        auto visit = [&](const auto& p_items) {
+            for (const auto& item : p_items) {
+                for (const auto& name : item.names) {
+                    p_function(std::string_view{ name });
+                }
+            }
+        };
+        visit(m_parameters.flag_options);
+        visit(m_parameters.optional_options);
+        visit(m_parameters.commands);
+    }
+
+
+    // Compiled parameters schema.
+    inline compiled_parameters_schema::compiled_parameters_schema(const compiled_parameters& p_parameters) :
+        error_handler(p_parameters.source().error_handler),
+        help_handler(p_parameters.source().help_handler),
+        m_parameters(p_parameters)
+    {}
+
+    inline void compiled_parameters_schema::set_current_parameter_group(context& p_context) const {
+        p_context.current_parameter_group = m_parameters.source();
+    }
+
+    inline std::size_t compiled_parameters_schema::required_option_count() const {
+        return m_parameters.m_required_setters.size();
+    }
+
+    inline std::string_view compiled_parameters_schema::required_option_name(std::size_t p_index) const {
+        return m_parameters.first_name(m_parameters.m_required_names[p_index]);
+    }
+
+    inline bool compiled_parameters_schema::set_required_option(std::size_t p_index, std::string_view p_value) const {
+        const auto& setter = m_parameters.m_required_setters[p_index];
+        return setter ? setter(p_value) : false;
+    }
+
+    inline std::size_t compiled_parameters_schema::find_flag(std::string_view p_name) const {
+        return m_parameters.find(name_kind::flag, p_name);
+    }
+
+    inline bool compiled_parameters_schema::set_flag(std::size_t p_index) const {
+        const auto& setter = m_parameters.m_flag_setters[p_index];
+        if (!setter) {
+            return false;
+        }
+        setter();
+        return true;
+    }
+
+    inline std::size_t compiled_parameters_schema::find_optional_option(std::string_view p_name) const {
+        return m_parameters.find(name_kind::optional, p_name);
+    }
+
+    inline std::string_view compiled_parameters_schema::optional_option_name(std::size_t p_index) const {
+        return m_parameters.first_name(m_parameters.m_optional_names[p_index]);
+    }
+
+    inline bool compiled_parameters_schema::set_optional_option(std::size_t p_index, std::string_view p_value) const {
+        const auto& setter = m_parameters.m_optional_setters[p_index];
+        return setter ? setter(p_value) : false;
+    }
+
+    inline std::size_t compiled_parameters_schema::find_short_name(char p_name, name_kind& p_kind) const {
+        return m_parameters.m_short_names.find(p_name, p_kind);
+    }
+
+    inline bool compiled_parameters_schema::has_rest_arguments() const {
+        return m_parameters.source().rest_handler.has_value();
+    }
+
+    inline void compiled_parameters_schema::set_rest_arguments(const argument_span& p_arguments) const {
+        *m_parameters.source().rest_handler->value = p_arguments;
+    }
+
+    inline bool compiled_parameters_schema::has_commands() const {
+        return !m_parameters.m_command_callbacks.empty();
+    }
+
+    inline std::size_t compiled_parameters_schema::find_command(std::string_view p_name) const {
+        return m_parameters.find(name_kind::command, p_name);
+    }
+
+    inline std::string_view compiled_parameters_schema::command_name(std::size_t p_index) const {
+        return m_parameters.first_name(m_parameters.m_command_names[p_index]);
+    }
+
+    inline int compiled_parameters_schema::call_command(std::size_t p_index, context& p_context) const {
+        const auto& callback = m_parameters.m_command_callbacks[p_index];
+        return callback ? callback(p_context) : parse_codes::successful;
+    }
+
+    inline int compiled_parameters_schema::call_help(const help& p_help, context& p_context) const {
+        return p_help.callback(p_context);
+    }
+
+
+    inline bool compiled_parameters_schema::has_abbreviations() const {
+        return m_parameters.source().allow_abbreviations;
+    }
+
+    inline std::string_view compiled_parameters_schema::expand_abbreviation(std::string_view p_name, bool& p_ambiguous) const {
+        if (find_flag(p_name) != npos || find_optional_option(p_name) != npos || find_command(p_name) != npos) {
+            return p_name;
+        }
+        return m_parameters.source().m_abbreviation_index.expand(m_parameters.source(), p_name, p_ambiguous);
+    }
+
+    inline std::size_t compiled_parameters_schema::abbreviation_candidates(std::string_view p_prefix, std::string_view* p_output, std::size_t p_max_count) const {
+        return m_parameters.source().m_abbreviation_index.candidates(m_parameters.source(), p_prefix, p_output, p_max_count);
+    }
+
+    inline bool compiled_parameters_schema::has_environment() const {
+        const command* matched_command = nullptr;
+        return parameters_schema{ m_parameters.source(), matched_command }.has_environment();
+    }
+
+    inline std::string_view compiled_parameters_schema::required_option_environment(std::size_t p_index) const {
+        return m_parameters.source().required_options[p_index].environment;
+    }
+
+    template<typename TFunction>
+    inline void compiled_parameters_schema::visit_environment(TFunction&& p_function) const {
+        const command* matched_command = nullptr;
+        parameters_schema{ m_parameters.source(), matched_command }.visit_environment(std::forward<TFunction>(p_function));
+    }
+
+    template<typename TFunction>
+    inline void compiled_parameters_schema::visit_names(TFunction&& p_function) const {
+        for (std::size_t i = 0; i < m_parameters.name_count(); ++i) {
+            p_function(m_parameters.name(i));
+        }
+    }
+
+
+    // Detached parameters schema.
+    inline detached_parameters_schema::detached_parameters_schema(const detached_parameters& p_parameters, parse_result& p_result) :
+        error_handler(p_parameters.error_handler),
+        help_handler(p_parameters.help_handler),
+        m_parameters(p_parameters),
+        m_result(p_result)
+    {}
+
+    inline void detached_parameters_schema::set_current_parameter_group(context& p_context) const {
+        p_context.current_parameter_group.reset();
+    }
+
+    inline std::size_t detached_parameters_schema::required_option_count() const {
+        return m_parameters.m_required_options.size();
+    }
+
+    inline std::string_view detached_parameters_schema::required_option_name(std::size_t p_index) const {
+        const auto& names = m_parameters.m_required_options[p_index].names;
+        return !names.empty() ? std::string_view{ names.front() } : std::string_view{ "opt" };
+    }
+
+    inline bool detached_parameters_schema::set_required_option(std::size_t p_index, std::string_view p_value) const {
+        return set_option(m_parameters.m_required_options[p_index], p_value);
+    }
+
+    inline std::size_t detached_parameters_schema::find_flag(std::string_view p_name) const {
+        return m_parameters.m_lookup_index.find(name_kind::flag, p_name, m_parameters);
+    }
+
+    inline bool detached_parameters_schema::set_flag(std::size_t p_index) const {
+        const auto& flag = m_parameters.m_flag_options[p_index];
+        const auto value = true;
+        std::memcpy(m_result.slot(flag.offset), &value, sizeof(value));
+        m_result.set(flag.index);
+        return true;
+    }
+
+    inline std::size_t detached_parameters_schema::find_optional_option(std::string_view p_name) const {
+        return m_parameters.m_lookup_index.find(name_kind::optional, p_name, m_parameters);
+    }
+
+    inline std::string_view detached_parameters_schema::optional_option_name(std::size_t p_index) const {
+        const auto& names = m_parameters.m_optional_options[p_index].names;
+        return !names.empty() ? std::string_view{ names.front() } : std::string_view{ "opt" };
+    }
+
+    inline bool detached_parameters_schema::set_optional_option(std::size_t p_index, std::string_view p_value) const {
+        return set_option(m_parameters.m_optional_options[p_index], p_value);
+    }
+
+    inline std::size_t detached_parameters_schema::find_short_name(char p_name, name_kind& p_kind) const {
+        return m_parameters.m_lookup_index.find_short(p_name, p_kind);
+    }
+
+    inline bool detached_parameters_schema::has_rest_arguments() const {
+        return false;
+    }
+
+    inline void detached_parameters_schema::set_rest_arguments(const argument_span&) const {
+    }
+
+    inline bool detached_parameters_schema::has_commands() const {
+        return !m_parameters.m_commands.empty();
+    }
+
+    inline std::size_t detached_parameters_schema::find_command(std::string_view p_name) const {
+        return m_parameters.m_lookup_index.find(name_kind::command, p_name, m_parameters);
+    }
+
+    inline std::string_view detached_parameters_schema::command_name(std::size_t p_index) const {
+        const auto& names = m_parameters.m_commands[p_index].names;
+        return !names.empty() ? std::string_view{ names.front() } : std::string_view{ "opt" };
+    }
+
+    inline int detached_parameters_schema::call_command(std::size_t p_index, context&) const {
+        m_result.m_command = p_index;
+        return parse_codes::successful;
+    }
+
+    inline int detached_parameters_schema::call_help(const help& p_help, context& p_context) const {
+        // Default help renders from a parameters object, so build one with placeholder values.
+        auto placeholder_value = std::string{};
+        auto placeholder_optional_value = std::optional<std::string>{};
+        auto placeholder_flag = false;
+
+        auto help_parameters = parameters{};
+        for (const auto& option : m_parameters.m_required_options) {
+            help_parameters.add_option(cppli::option<std::string>{ placeholder_value, option.names, option.description });
+        }
+        for (const auto& option : m_parameters.m_optional_options) {
+            help_parameters.add_option(cppli::option<std::optional<std::string>>{ placeholder_optional_value, option.names, option.description });
+        }
+        for (const auto& option : m_parameters.m_flag_options) {
+            help_parameters.add_option(option_flag<bool>{ placeholder_flag, option.names, option.description });
+        }
+        for (const auto& command : m_parameters.m_commands) {
+            help_parameters.add_command(cppli::command{ command.names, command.description });
+        }
+        help_parameters.error_handler = m_parameters.error_handler;
+        help_parameters.help_handler = m_parameters.help_handler;
+
+        p_context.current_parameter_group = help_parameters;
+        const auto result = p_help.callback(p_context);
+        p_context.current_parameter_group.reset();
+        return result;
+    }
+
+    inline bool detached_parameters_schema::has_abbreviations() const {
+        return false;
+    }
+
+    inline std::string_view detached_parameters_schema::expand_abbreviation(std::string_view p_name, bool&) const {
+        return p_name;
+    }
+
+    inline std::size_t detached_parameters_schema::abbreviation_candidates(std::string_view, std::string_view*, std::size_t) const {
+        return 0;
+    }
+
+    inline bool detached_parameters_schema::has_environment() const {
+        return false;
+    }
+
+    inline std::string_view detached_parameters_schema::required_option_environment(std::size_t) const {
+        return {};
+    }
+
+    template<typename TFunction>
+    inline void detached_parameters_schema::visit_environment(TFunction&&) const
+    {}
+
+    template<typename TFunction>
+    inline void detached_parameters_schema::visit_names(TFunction&& p_function) const {
+        auto visit = [&](const auto& p_items) {
+            for (const auto& item : p_items) {
+                for (const auto& name : item.names) {
+                    p_function(std::string_view{ name });
+                }
+            }
+        };
+        visit(m_parameters.m_flag_options);
+        visit(m_parameters.m_optional_options);
+        visit(m_parameters.m_commands);
+    }
+
+    inline bool detached_parameters_schema::set_option(const detached_option& p_option, std::string_view p_value) const {
+        if (!p_option.set_value(m_result.slot(p_option.offset), p_value)) {
+            return false;
+        }
+        m_result.set(p_option.index);
+        return true;
+    }
+
+
+    // Static parameters schema.
+    template<typename... TElements>
+    inline static_parameters_schema<TElements...>::static_parameters_schema(const static_parameters<TElements...>& p_parameters) :
+        error_handler(p_parameters.error_handler),
+        help_handler(p_parameters.help_handler),
+        m_parameters(p_parameters)
+    {}
+
+    template<typename... TElements>
+    inline void static_parameters_schema<TElements...>::set_current_parameter_group(context& p_context) const {
+        p_context.current_parameter_group.reset();
+    }
+
+    template<typename... TElements>
+    constexpr std::size_t static_parameters_schema<TElements...>::required_option_count() const {
+        return count_static_elements<is_static_required_option, TElements...>();
+    }
+
+    template<typename... TElements>
+    inline std::string_view static_parameters_schema<TElements...>::required_option_name(std::size_t p_index) const {
+        return element_name<is_static_required_option>(p_index);
+    }
+
+    template<typename... TElements>
+    inline bool static_parameters_schema<TElements...>::set_required_option(std::size_t p_index, std::string_view p_value) const {
+        bool result = false;
+        visit_static_elements<is_static_required_option>(m_parameters.elements, [&](const auto& p_option, std::size_t p_option_index) {
+            if (p_option_index != p_index) {
+                return false;
+            }
+            result = parse_value(p_option.value, p_value);
+            return true;
+        });
+        return result;
+    }
+
+    template<typename... TElements>
+    inline std::size_t static_parameters_schema<TElements...>::find_flag(std::string_view p_name) const {
+        return find_element<is_static_flag>(p_name);
+    }
+
+    template<typename... TElements>
+    inline bool static_parameters_schema<TElements...>::set_flag(std::size_t p_index) const {
+        return visit_static_elements<is_static_flag>(m_parameters.elements, [&](const auto& p_flag, std::size_t p_flag_index) {
+            if (p_flag_index != p_index) {
+                return false;
+            }
+            set_flag_value(p_flag.value);
+            return true;
+        });
+    }
+
+    template<typename... TElements>
+    inline std::size_t static_parameters_schema<TElements...>::find_optional_option(std::string_view p_name) const {
+        return find_element<is_static_optional_option>(p_name);
+    }
+
+    template<typename... TElements>
+    inline std::string_view static_parameters_schema<TElements...>::optional_option_name(std::size_t p_index) const {
+        return element_name<is_static_optional_option>(p_index);
+    }
+
+    template<typename... TElements>
+    inline bool static_parameters_schema<TElements...>::set_optional_option(std::size_t p_index, std::string_view p_value) const {
+        bool result = false;
+        visit_static_elements<is_static_optional_option>(m_parameters.elements, [&](const auto& p_option, std::size_t p_option_index) {
+            if (p_option_index != p_index) {
+                return false;
+            }
+            result = parse_value(p_option.value, p_value);
+            return true;
+        });
+        return result;
+    }
+
+    template<typename... TElements>
+    inline std::size_t static_parameters_schema<TElements...>::find_short_name(char p_name, name_kind& p_kind) const {
+        return find_short_name_by_lookup(*this, p_name, p_kind);
+    }
+
+    template<typename... TElements>
+    constexpr bool static_parameters_schema<TElements...>::has_rest_arguments() const {
+        return false;
+    }
+
+    template<typename... TElements>
+    inline void static_parameters_schema<TElements...>::set_rest_arguments(const argument_span&) const {
+    }
+
+    template<typename... TElements>
+    constexpr bool static_parameters_schema<TElements...>::has_commands() const {
+        return count_static_elements<is_static_command, TElements...>() > 0;
+    }
+
+    template<typename... TElements>
+    inline std::size_t static_parameters_schema<TElements...>::find_command(std::string_view p_name) const {
+        return find_element<is_static_command>(p_name);
+    }
+
+    template<typename... TElements>
+    inline std::string_view static_parameters_schema<TElements...>::command_name(std::size_t p_index) const {
+        return element_name<is_static_command>(p_index);
+    }
+
+    template<typename... TElements>
+    inline constexpr bool static_parameters_schema<TElements...>::has_abbreviations() const {
+        return false;
+    }
+
+    template<typename... TElements>
+    inline std::string_view static_parameters_schema<TElements...>::expand_abbreviation(std::string_view p_name, bool&) const {
+        return p_name;
+    }
+
+    template<typename... TElements>
+    inline std::size_t static_parameters_schema<TElements...>::abbreviation_candidates(std::string_view, std::string_view*, std::size_t) const {
+        return 0;
+    }
+
+    template<typename... TElements>
+    inline constexpr bool static_parameters_schema<TElements...>::has_environment() const {
+        return false;
+    }
+
+    template<typename... TElements>
+    inline std::string_view static_parameters_schema<TElements...>::required_option_environment(std::size_t) const {
+        return {};
+    }
+
+    template<typename... TElements>
+    template<typename TFunction>
+    inline void static_parameters_schema<TElements...>::visit_environment(TFunction&&) const
+    {}
+
+    template<typename... TElements>
+    template<typename TFunction>
+    inline void static_parameters_schema<TElements...>::visit_names(TFunction&& p_function) const {
+        auto visit = [&](const auto& p_element, std::size_t) {
+            auto names = std::string_view{ p_element.names };
+            while (!names.empty()) {
+                const auto separator = names.find('|');
+                p_function(names.substr(0, separator));
+                names = separator != std::string_view::npos ? names.substr(separator + 1) : std::string_view{};
+            }
+            return false;
+        };
+        visit_static_elements<is_static_flag>(m_parameters.elements, visit);
+        visit_static_elements<is_static_optional_option>(m_parameters.elements, visit);
+        visit_static_elements<is_static_command>(m_parameters.elements, visit);
+    }
+
+    template<typename... TElements>
+    inline int static_parameters_schema<TElements...>::call_command(std::size_t p_index, context& p_context) const {
+        int result = parse_codes::successful;
+        visit_static_elements<is_static_command>(m_parameters.elements, [&](const auto& p_command, std::size_t p_command_index) {
+            if (p_command_index != p_index) {
+                return false;
+            }
+            if constexpr (std::is_pointer_v<std::decay_t<decltype(p_command.callback)>>) {
+                result = p_command.callback ? p_command.callback(p_context) : parse_codes::successful;
+            }
+            else {
+                result = p_command.callback(p_context);
+            }
+            return true;
+        });
+        return result;
+    }
+
+    template<typename... TElements>
+    inline int static_parameters_schema<TElements...>::call_help(const help& p_help, context& p_context) const {
+        const auto help_parameters = m_parameters.to_parameters();
+        p_context.current_parameter_group = help_parameters;
+        const auto result = p_help.callback(p_context);
+        p_context.current_parameter_group.reset();
+        return result;
+    }
+
+    template<typename... TElements>
+    template<template<typename> typename TKind>
+    inline std::size_t static_parameters_schema<TElements...>::find_element(std::string_view p_name) const {
+        auto result = npos;
+        visit_static_elements<TKind>(m_parameters.elements, [&](const auto& p_element, std::size_t p_element_index) {
+            if (!static_names_contain(p_element.names, p_name)) {
+                return false;
+            }
+            result = p_element_index;
+            return true;
+        });
+        return result;
+    }
+
+    template<typename... TElements>
+    template<template<typename> typename TKind>
+    inline std::string_view static_parameters_schema<TElements...>::element_name(std::size_t p_index) const {
+        auto result = std::string_view{};
+        visit_static_elements<TKind>(m_parameters.elements, [&](const auto& p_element, std::size_t p_element_index) {
+            if (p_element_index != p_index) {
+                return false;
+            }
+            result = static_first_name(p_element.names);
+            return true;
+        });
+        return result;
+    }
+
+
+    // Parse.
+    template<typename TSchema>
+    inline int parse_schema(context& p_context, const TSchema& p_schema) {
+        p_schema.set_current_parameter_group(p_context);
+
+        auto* current_help_handler = impl::get_help_handler(p_context, p_schema);
+        auto* current_error_handler = impl::get_error_handler(p_context, p_schema);
+        auto* current_error_callback = get_error_callback(current_error_handler);
+        auto error_callback = [current_error_callback, &p_schema](context& p_error_context, int p_code, std::string_view p_token, std::string_view p_name) {
+            if (current_error_callback != nullptr) {
+                const auto suggest = p_code == cppli::parse_codes::unknown_option || p_code == cppli::parse_codes::unknown_command;
+                const auto ambiguous = p_code == cppli::parse_codes::ambiguous_name;
+                (*current_error_callback)(p_error_context, parse_error{
+                    p_code,
+                    p_token,
+                    p_name,
+                    p_error_context.arg_index,
+                    suggest || ambiguous ? static_cast<const void*>(&p_schema) : nullptr,
+                    suggest ? &suggest_schema_names<TSchema> : (ambiguous ? &abbreviation_schema_candidates<TSchema> : nullptr) });
+            }
+        };
+
+        // Options missing from the arguments fall back to the environment, and then to the config file.
+        const auto use_fallbacks = p_schema.has_environment() || p_context.config != nullptr;
+        auto option_marks = impl::option_marks{ p_context.memory_resource() };
+        auto set_fallback = [&](name_kind p_kind, std::size_t p_index, std::string_view p_value, std::string_view p_name) {
+            auto enabled = false;
+            const auto is_set = p_kind == name_kind::flag ?
+                parse_value(enabled, p_value) && (!enabled || p_schema.set_flag(p_index)) :
+                p_schema.set_optional_option(p_index, p_value);
+            if (!is_set) {
+                error_callback(p_context, cppli::parse_codes::invalid_option_value, p_value, p_name);
+                return cppli::parse_codes::invalid_option_value;
+            }
+            option_marks.mark(p_kind, p_index);
+            return cppli::parse_codes::successful;
+        };
+        auto apply_fallbacks = [&]() {
+            auto result = cppli::parse_codes::successful;
+            p_schema.visit_environment([&](name_kind p_kind, std::size_t p_index, std::string_view p_variable, std::string_view p_name) {
+                if (result != cppli::parse_codes::successful || option_marks.is_marked(p_kind, p_index)) {
+                    return;
+                }
+                if (const auto value = find_schema_environment(p_context, p_variable); value.has_value()) {
+                    result = set_fallback(p_kind, p_index, value.value(), p_name);
+                }
+            });
+
+            if (result == cppli::parse_codes::successful && p_context.config != nullptr) {
+                const auto [path, depth] = config_section_path(p_context);
+                p_context.config->visit_section(path, depth, [&](const config_file::entry& p_entry) {
+                    if (result != cppli::parse_codes::successful) {
+                        return;
+                    }
+                    auto kind = name_kind::flag;
+                    const auto index = find_config_option(p_schema, p_entry.key, kind);
+                    if (index == TSchema::npos) {
+                        // Required options read their keys while the arguments are parsed.
+                        for (std::size_t required = 0; required < p_schema.required_option_count(); ++required) {
+                            if (p_schema.required_option_name(required) == p_entry.key) {
+                                return;
+                            }
+                        }
+                        error_callback(p_context, cppli::parse_codes::unknown_option, p_entry.key, {});
+                        result = cppli::parse_codes::unknown_option;
+                        return;
+                    }
+                    if (!option_marks.is_marked(kind, index)) {
+                        result = set_fallback(kind, index, p_entry.value, p_entry.key);
+                    }
+                });
+            }
+            return result;
+        };
+
+        // Getopt forms, "--name=value", "-ovalue" and clustered flags like "-dv", are sliced from the argument in place.
+        auto parse_getopt_form = [&](std::string_view p_arg, int& p_result) {
+            if (p_arg.size() < 3 || p_arg[0] != '-') {
+                return false;
+            }
+
+            if (p_arg[1] == '-') {
+                const auto equals = p_arg.find('=');
+                if (equals == std::string_view::npos) {
+                    return false;
+                }
+                auto name = p_arg.substr(0, equals);
+                const auto value = p_arg.substr(equals + 1);
+                if (p_schema.has_abbreviations() && is_abbreviation_candidate(name)) {
+                    auto ambiguous = false;
+                    name = p_schema.expand_abbreviation(name, ambiguous);
+                    if (ambiguous) {
+                        error_callback(p_context, cppli::parse_codes::ambiguous_name, name, {});
+                        p_result = cppli::parse_codes::ambiguous_name;
+                        return true;
+                    }
+                }
+                if (p_schema.find_flag(name) != TSchema::npos) {
+                    error_callback(p_context, cppli::parse_codes::invalid_option_value, value, name);
+                    p_result = cppli::parse_codes::invalid_option_value;
+                    return true;
+                }
+                const auto optional = p_schema.find_optional_option(name);
+                if (optional == TSchema::npos) {
+                    return false;
+                }
+                if (!p_schema.set_optional_option(optional, value)) {
+                    error_callback(p_context, cppli::parse_codes::invalid_option_value, value, p_schema.optional_option_name(optional));
+                    p_result = cppli::parse_codes::invalid_option_value;
+                    return true;
+                }
+                if (use_fallbacks) {
+                    option_marks.mark(name_kind::optional, optional);
+                }
+                p_context.move_to_next_arg();
+                return true;
+            }
+
+            auto kind = name_kind::flag;
+            if (p_schema.find_short_name(p_arg[1], kind) == TSchema::npos) {
+                return false;
+            }
+
+            for (std::size_t position = 1; position < p_arg.size(); ++position) {
+                const auto index = p_schema.find_short_name(p_arg[position], kind);
+                if (index == TSchema::npos) {
+                    error_callback(p_context, cppli::parse_codes::unknown_option, p_arg, {});
+                    p_result = cppli::parse_codes::unknown_option;
+                    return true;
+                }
+
+                if (kind == name_kind::flag) {
+                    if (!p_schema.set_flag(index)) {
+                        error_callback(p_context, cppli::parse_codes::invalid_option_value, {}, p_arg);
+                        p_result = cppli::parse_codes::invalid_option_value;
+                        return true;
+                    }
+                    if (use_fallbacks) {
+                        option_marks.mark(name_kind::flag, index);
+                    }
+                    continue;
+                }
+
+                // The rest of the argument is the value, or the next argument if nothing is left.
+                auto value = p_arg.substr(position + 1);
+                if (value.empty()) {
+                    p_context.move_to_next_arg();
+                    if (p_context.argc <= 0) {
+                        error_callback(p_context, cppli::parse_codes::missing_option_value, {}, p_schema.optional_option_name(index));
+                        p_result = cppli::parse_codes::missing_option_value;
+                        return true;
+                    }
+                    value = p_context.current_arg();
+                }
+                if (!p_schema.set_optional_option(index, value)) {
+                    error_callback(p_context, cppli::parse_codes::invalid_option_value, value, p_schema.optional_option_name(index));
+                    p_result = cppli::parse_codes::invalid_option_value;
+                    return true;
+                }
+                if (use_fallbacks) {
+                    option_marks.mark(name_kind::optional, index);
+                }
+                break;
+            }
+
+            p_context.move_to_next_arg();
+            return true;
+        };
+
+        // Rest arguments start at "--", or at the first positional argument that is not a name.
+        auto parse_rest_arguments = [&](std::string_view p_arg) {
+            if (!p_schema.has_rest_arguments()) {
+                return false;
+            }
+            if (p_arg == "--") {
+                p_context.move_to_next_arg();
+            }
+            else if (p_arg.size() > 1 && p_arg[0] == '-') {
+                return false;
+            }
+            p_schema.set_rest_arguments(take_rest_arguments(p_context));
+            return true;
+        };
+
+        if (!handle_first_arg_is_path(p_context)) {
+            error_callback(p_context, cppli::parse_codes::missing_path, {}, {});
+            return cppli::parse_codes::missing_path;
+        }
+
+        // Help
+        if (current_help_handler != nullptr && current_help_handler->callback &&
+            p_context.argc > 0 && current_help_handler->has_name(p_context.current_arg()))
+        {
+            return p_schema.call_help(*current_help_handler, p_context);
+        }
+
+        // Required options.
+        for (std::size_t index = 0; index < p_schema.required_option_count(); ++index) {
+            const auto first_opt_name = p_schema.required_option_name(index);
+
+            if (p_context.argc <= 0) {
+                auto fallback_value = p_schema.has_environment() ?
+                    find_schema_environment(p_context, p_schema.required_option_environment(index)) :
+                    std::optional<std::string_view>{};
+                if (!fallback_value.has_value() && p_context.config != nullptr) {
+                    const auto [path, depth] = config_section_path(p_context);
+                    fallback_value = p_context.config->find(path, depth, first_opt_name);
+                }
+                if (!fallback_value.has_value()) {
+                    error_callback(p_context, cppli::parse_codes::missing_option, {}, first_opt_name);
+                    return cppli::parse_codes::missing_option;
+                }
+                if (!p_schema.set_required_option(index, fallback_value.value())) {
+                    error_callback(p_context, cppli::parse_codes::invalid_option_value, fallback_value.value(), first_opt_name);
+                    return cppli::parse_codes::invalid_option_value;
+                }
+                continue;
+            }
+
+            const auto opt_value = p_context.current_arg();
+
+            if (!p_schema.set_required_option(index, opt_value)) {
+                error_callback(p_context, cppli::parse_codes::invalid_option_value, opt_value, first_opt_name);
+                return cppli::parse_codes::invalid_option_value;
+            }
+
+            p_context.move_to_next_arg();
+        }
+
+        do {
+            if (p_context.argc <= 0) {
+                if (p_schema.has_commands()) {
+                    error_callback(p_context, cppli::parse_codes::missing_command, {}, {});
+                    return cppli::parse_codes::missing_command;
+                }
+                else {
+                    return use_fallbacks ? apply_fallbacks() : cppli::parse_codes::successful;
+                }
+            }
+
+            auto opt_name = p_context.current_arg();
+
+            if (opt_name == "--") {
+                // Rest arguments stand in for a command, as a positional argument does, but an empty rest does not.
+                const auto has_rest = p_context.argc > 1;
+                if (parse_rest_arguments(opt_name)) {
+                    if (!has_rest && p_schema.has_commands()) {
+                        error_callback(p_context, cppli::parse_codes::missing_command, {}, {});
+                        return cppli::parse_codes::missing_command;
+                    }
+                    continue;
+                }
+            }
+
+            // Unique prefixes of names.
+            if (p_schema.has_abbreviations() && is_abbreviation_candidate(opt_name)) {
+                auto ambiguous = false;
+                opt_name = p_schema.expand_abbreviation(opt_name, ambiguous);
+                if (ambiguous) {
+                    error_callback(p_context, cppli::parse_codes::ambiguous_name, opt_name, {});
+                    return cppli::parse_codes::ambiguous_name;
+                }
+            }
+
+            // Flag options.
+            if (auto flag = p_schema.find_flag(opt_name); flag != TSchema::npos) {
+                if (!p_schema.set_flag(flag)) {
+                    error_callback(p_context, cppli::parse_codes::invalid_option_value, {}, opt_name);
+                    return cppli::parse_codes::invalid_option_value;
+                }
+                if (use_fallbacks) {
+                    option_marks.mark(name_kind::flag, flag);
+                }
+
+                p_context.move_to_next_arg();
+                continue;
+            }
+
+            // Optional options.
+            if (auto optional = p_schema.find_optional_option(opt_name); optional != TSchema::npos) {
+                p_context.move_to_next_arg();
+
+                const auto first_opt_name = p_schema.optional_option_name(optional);
+
+                if (p_context.argc <= 0) {
+                    error_callback(p_context, cppli::parse_codes::missing_option_value, {}, first_opt_name);
+                    return cppli::parse_codes::missing_option_value;
+                }
+
+                const auto opt_value = p_context.current_arg();
+
+                if (!p_schema.set_optional_option(optional, opt_value)) {
+                    error_callback(p_context, cppli::parse_codes::invalid_option_value, opt_value, first_opt_name);
+                    return cppli::parse_codes::invalid_option_value;
+                }
+                if (use_fallbacks) {
+                    option_marks.mark(name_kind::optional, optional);
+                }
+
+                p_context.move_to_next_arg();
+                continue;
+            }
+
+            if (auto result = int{ cppli::parse_codes::successful }; parse_getopt_form(opt_name, result)) {
+                if (result != cppli::parse_codes::successful) {
+                    return result;
+                }
+                continue;
+            }
+
+            if (!p_schema.has_commands()) {
+                if (parse_rest_arguments(p_context.current_arg())) {
+                    continue;
+                }
+                error_callback(p_context, cppli::parse_codes::unknown_option, opt_name, {});
+                return cppli::parse_codes::unknown_option;
+            }
+
+            // Command
+            if (auto command = p_schema.find_command(opt_name); command != TSchema::npos) {
+                if (use_fallbacks) {
+                    if (const auto result = apply_fallbacks(); result != cppli::parse_codes::successful) {
+                        return result;
+                    }
+                }
+
+                p_context.current_path.emplace_back(opt_name);
+                p_context.command_path.push_back(p_schema.command_name(command));
+                p_context.move_to_next_arg();
+
+                return p_schema.call_command(command, p_context);
+            }
+
+            // Help
+            if (current_help_handler != nullptr && current_help_handler->callback &&
+                current_help_handler->has_name(opt_name))
+            {
+                return p_schema.call_help(*current_help_handler, p_context);
+            }
+
+            if (parse_rest_arguments(p_context.current_arg())) {
+                continue;
+            }
+
+            error_callback(p_context, cppli::parse_codes::unknown_command, opt_name, {});
+            return cppli::parse_codes::unknown_command;
+
+        } while (p_context.argc > 0);
+
+        return use_fallbacks ? apply_fallbacks() : cppli::parse_codes::successful;
+    }
+
+    inline argument_span take_rest_arguments(context& p_context) {
+        const auto count = static_cast<std::size_t>(p_context.argc > 0 ? p_context.argc : 0);
+        auto result = argument_span{};
+        if (p_context.tokens != nullptr) {
+            result = argument_span{ p_context.tokens, count };
+            p_context.tokens += count;
+        }
+        else {
+            result = argument_span{ p_context.argv, count };
+            p_context.argv += count;
+        }
+        p_context.arg_index += static_cast<int>(count);
+        p_context.argc = 0;
+        return result;
+    }
+
+    template<typename TString>
+    inline void append_parse_error_message(const parse_error& p_error, TString& p_result) {
+        auto append_quoted = [&](std::string_view p_string) {
+            p_result += '\'';
+            p_result += p_string;
+            p_result += '\'';
+        };
+
+        auto append_did_you_mean = [&]() {
+            auto names = std::array<std::string_view, parse_error::max_suggestions>{};
+            const auto count = p_error.suggestions(names.data(), names.size());
+            for (std::size_t i = 0; i < count; ++i) {
+                p_result += i == 0 ? " Did you mean " : (i + 1 == count ? " or " : ", ");
+                append_quoted(names[i]);
+            }
+            if (count > 0) {
+                p_result += '?';
+            }
+        };
+
+        auto append_named = [&](const char* p_prefix, std::string_view p_string, const char* p_suffix) {
+            p_result += p_prefix;
+            append_quoted(p_string);
+            p_result += p_suffix;
+        };
+
+        switch (p_error.code) {
+            case parse_codes::missing_path: p_result += "Missing path."; break;
+            case parse_codes::unknown_command: append_named("Unknown command ", p_error.token, "."); append_did_you_mean(); break;
+            case parse_codes::missing_command: p_result += "Missing command."; break;
+            case parse_codes::unknown_option: append_named("Unknown option ", p_error.token, "."); append_did_you_mean(); break;
+            case parse_codes::ambiguous_name: append_named("Ambiguous name ", p_error.token, "."); append_did_you_mean(); break;
+            case parse_codes::missing_option: append_named("Missing option ", p_error.name, "."); break;
+            case parse_codes::missing_option_value: append_named("Missing value of option ", p_error.name, "."); break;
+            case parse_codes::invalid_option_value:
+                // Flags have no value token, in contrast to an empty argument.
+                if (p_error.token.data() == nullptr) {
+                    append_named("Failed to set flag of option ", p_error.name, ".");
+                    break;
+                }
+                append_named("Invalid value ", p_error.token, " of option ");
+                append_named("", p_error.name, ".");
+                break;
+            default: break;
+        }
+    }
+
+    inline std::optional<std::string_view> find_schema_environment(context& p_context, std::string_view p_variable) {
+        if (p_variable.empty()) {
+            return std::nullopt;
+        }
+        return p_context.find_environment(p_variable);
+    }
+
+    template<typename TSchema>
+    inline std::size_t find_short_name_by_lookup(const TSchema& p_schema, char p_name, name_kind& p_kind) {
+        const char name[2] = { '-', p_name };
+        if (const auto flag = p_schema.find_flag(std::string_view{ name, 2 }); flag != TSchema::npos) {
+            p_kind = name_kind::flag;
+            return flag;
+        }
+        p_kind = name_kind::optional;
+        return p_schema.find_optional_option(std::string_view{ name, 2 });
+    }
+
+    template<typename TSchema>
+    inline std::size_t find_config_option(const TSchema& p_schema, std::string_view p_key, name_kind& p_kind) {
+        auto find = [&](std::string_view p_name) {
+            if (const auto flag = p_schema.find_flag(p_name); flag != TSchema::npos) {
+                p_kind = name_kind::flag;
+                return flag;
+            }
+            p_kind = name_kind::optional;
+            return p_schema.find_optional_option(p_name);
+        };
+
+        // Keys are usually written without dashes, "jobs" for "--jobs" or "j" for "-j".
+        auto buffer = std::array<char, 128>{};
+        if (p_key.empty() || p_key.front() == '-' || p_key.size() + 2 > buffer.size()) {
+            return find(p_key);
+        }
+        buffer[0] = '-';
+        buffer[1] = '-';
+        std::memcpy(buffer.data() + 2, p_key.data(), p_key.size());
+        if (const auto index = find(std::string_view{ buffer.data(), p_key.size() + 2 }); index != TSchema::npos) {
+            return index;
+        }
+        if (const auto index = find(std::string_view{ buffer.data() + 1, p_key.size() + 1 }); index != TSchema::npos) {
+            return index;
+        }
+        return find(p_key);
+    }
+
+    inline std::pair<const std::string_view*, std::size_t> config_section_path(const context& p_context) {
+        // Sections are named by the first name of each command, not by the alias or prefix that was typed.
+        return { p_context.command_path.data(), p_context.command_path.size() };
+    }
+
+    inline int parse_command_tree(context& p_context, const parameters& p_parameters, const command* p_owner) {
+        const auto* current_parameters = &p_parameters;
+        const auto* current_owner = p_owner;
+
+        while (true) {
+            const command* matched_command = nullptr;
+            const auto result = parse_schema(p_context, parameters_schema{ *current_parameters, matched_command });
+
+            if (matched_command == nullptr) {
+                if (result == parse_codes::successful && current_owner != nullptr && current_owner->callback) {
+                    return current_owner->callback(p_context);
+                }
+                return result;
+            }
+            if (!matched_command->child_parameters) {
+                return result;
+            }
+
+            current_parameters = matched_command->child_parameters.get();
+            current_owner = matched_command;
+        }
+    }
+
+    inline std::size_t edit_distance(
+        const std::array<std::uint64_t, 256>& p_pattern_masks,
+        std::size_t p_pattern_length,
+        std::string_view p_text,
+        std::size_t p_max_distance)
+    {
+        // Myers' bit-parallel algorithm, in Hyyrö's formulation for the distance between two whole strings.
+        const auto last_bit = std::uint64_t{ 1 } << (p_pattern_length - 1);
+        auto positive_vertical = ~std::uint64_t{ 0 };
+        auto negative_vertical = std::uint64_t{ 0 };
+        auto distance = p_pattern_length;
+
+        auto remaining = p_text.size();
+        for (const auto character : p_text) {
+            const auto equal = p_pattern_masks[static_cast<unsigned char>(character)];
+            const auto vertical = equal | negative_vertical;
+            const auto horizontal = (((equal & positive_vertical) + positive_vertical) ^ positive_vertical) | equal;
+            auto positive_horizontal = negative_vertical | ~(horizontal | positive_vertical);
+            auto negative_horizontal = positive_vertical & horizontal;
+
+            if (positive_horizontal & last_bit) {
+                ++distance;
+            }
+            else if (negative_horizontal & last_bit) {
+                --distance;
+            }
+
+            positive_horizontal = (positive_horizontal << 1) | 1;
+            negative_horizontal <<= 1;
+            positive_vertical = negative_horizontal | ~(vertical | positive_horizontal);
+            negative_vertical = positive_horizontal & vertical;
+
+            // The distance drops by at most one per remaining character.
+            --remaining;
+            if (distance > remaining && distance - remaining > p_max_distance) {
+                return p_max_distance + 1;
+            }
+        }
+
+        return distance;
+    }
+
+    template<typename TVisitor>
+    inline std::size_t suggest_names(std::string_view p_token, std::string_view* p_output, std::size_t p_max_count, TVisitor&& p_visitor) {
+        constexpr auto max_pattern_length = std::size_t{ 64 };
+        constexpr auto max_count = std::size_t{ 8 };
+
+        p_max_count = std::min(p_max_count, max_count);
+        if (p_token.empty() || p_token.size() > max_pattern_length || p_max_count == 0) {
+            return 0;
+        }
+
+        auto pattern_masks = std::array<std::uint64_t, 256>{};
+        for (std::size_t i = 0; i < p_token.size(); ++i) {
+            pattern_masks[static_cast<unsigned char>(p_token[i])] |= std::uint64_t{ 1 } << i;
+        }
+
+        const auto max_distance = p_token.size() <= 4 ? std::size_t{ 1 } : p_token.size() <= 8 ? std::size_t{ 2 } : std::size_t{ 3 };
+        auto distances = std::array<std::size_t, max_count>{};
+        std::size_t count = 0;
+
+        p_visitor([&](std::string_view p_name) {
+            const auto length_difference = p_name.size() > p_token.size() ? p_name.size() - p_token.size() : p_token.size() - p_name.size();
+            if (p_name.empty() || length_difference > max_distance) {
+                return;
+            }
+
+            // Every character missing from the token costs at least one edit.
+            std::size_t missing_characters = 0;
+            for (const auto character : p_name) {
+                missing_characters += pattern_masks[static_cast<unsigned char>(character)] == 0 ? 1 : 0;
+            }
+            if (missing_characters > max_distance) {
+                return;
+            }
+
+            const auto distance = edit_distance(pattern_masks, p_token.size(), p_name, max_distance);
+            if (distance > max_distance || (count == p_max_count && distance >= distances[count - 1])) {
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                if (p_output[i] == p_name) {
+                    return;
+                }
+            }
+
+            // Insertion into the small sorted list, equal distances keep declaration order.
+            auto position = std::min(count, p_max_count - 1);
+            while (position > 0 && distances[position - 1] > distance) {
+                distances[position] = distances[position - 1];
+                p_output[position] = p_output[position - 1];
+                --position;
+            }
+            distances[position] = distance;
+            p_output[position] = p_name;
+            count = std::min(count + 1, p_max_count);
+        });
+
+        return count;
+    }
+
+    template<typename TSchema>
+    inline std::size_t suggest_schema_names(const void* p_schema, std::string_view p_token, std::string_view* p_output, std::size_t p_max_count) {
+        const auto& schema = *static_cast<const TSchema*>(p_schema);
+        return suggest_names(p_token, p_output, p_max_count, [&](auto&& p_function) {
+            schema.visit_names(p_function);
+        });
+    }
+
+    inline bool is_abbreviation_candidate(std::string_view p_token) {
+        // "-" and "--" are the stdin and end of options conventions, never prefixes of names.
+        return p_token.find_first_not_of('-') != std::string_view::npos;
+    }
+
+    template<typename TSchema>
+    inline std::size_t abbreviation_schema_candidates(const void* p_schema, std::string_view p_token, std::string_view* p_output, std::size_t p_max_count) {
+        return static_cast<const TSchema*>(p_schema)->abbreviation_candidates(p_token, p_output, p_max_count);
+    }
+
+    template<typename TFunction>
+    inline void complete_names(const parameters& p_parameters, const help* p_help, const argument_span& p_words, TFunction&& p_function) {
+        const auto* current_parameters = &p_parameters;
+        const auto* current_help = current_parameters->help_handler.has_value() ? &current_parameters->help_handler.value() : p_help;
+        auto required_option_count = current_parameters->required_options.size();
+
+        // Every word but the last is complete, the last one is the prefix being completed.
+        const auto count = p_words.size();
+        const auto last = count > 0 ? count - 1 : 0;
+        for (std::size_t index = 0; index < last; ++index) {
+            const auto word = p_words[index];
+
+            if (required_option_count > 0) {
+                --required_option_count;
+                continue;
+            }
+            if (current_parameters->find_flag(word) != nullptr) {
+                continue;
+            }
+            if (current_parameters->find_optional(word) != nullptr) {
+                if (index + 1 == last) {
+                    return;
+                }
+                ++index;
+                continue;
+            }
+            if (const auto* command = current_parameters->find_command(word); command != nullptr && command->child_parameters) {
+                current_parameters = command->child_parameters.get();
+                if (current_parameters->help_handler.has_value()) {
+                    current_help = &current_parameters->help_handler.value();
+                }
+                required_option_count = current_parameters->required_options.size();
+                continue;
+            }
+
+            // Leaf command, help or unknown token, nothing left to complete.
+            return;
+        }
+
+        // Option values are left to the shell.
+        if (required_option_count > 0) {
+            return;
+        }
+
+        const auto prefix = count > 0 ? p_words[last] : std::string_view{};
+        const auto complete_dashed = (!prefix.empty() && prefix.front() == '-') || current_parameters->commands.empty();
+        const auto complete_plain = prefix.empty() || prefix.front() != '-';
+
+        auto add_names = [&](const std::vector<std::string>& p_names) {
+            for (const auto& name : p_names) {
+                const auto dashed = !name.empty() && name.front() == '-';
+                if (!name.empty() && (dashed ? complete_dashed : complete_plain) && name.compare(0, prefix.size(), prefix) == 0) {
+                    p_function(std::string_view{ name });
+                }
+            }
+        };
+
+        for (const auto& command : current_parameters->commands) {
+            add_names(command.names);
+        }
+        for (const auto& option : current_parameters->optional_options) {
+            add_names(option.names);
+        }
+        for (const auto& flag : current_parameters->flag_options) {
+            add_names(flag.names);
+        }
+        if (current_help != nullptr && current_help->callback) {
+            add_names(current_help->names);
+        }
+    }
+
+    inline std::optional<int> parse_completion(context& p_context, const parameters& p_parameters, const completion& p_completion) {
+        const auto name_index = p_context.first_arg_is_path && p_context.arg_index == 0 ? 1 : 0;
+        if (p_context.argc <= name_index) {
+            return std::nullopt;
+        }
+
+        const auto name = p_context.tokens != nullptr ?
+            p_context.tokens[name_index] :
+            (p_context.argv[name_index] != nullptr ? std::string_view{ p_context.argv[name_index] } : std::string_view{});
+        if (name.empty() || name != p_completion.name) {
+            return std::nullopt;
+        }
+
+        handle_first_arg_is_path(p_context);
+        p_context.move_to_next_arg();
+
+        // Candidates are written through a stack buffer, the words are viewed in place.
+        const auto words = take_rest_arguments(p_context);
+        auto buffer = std::array<char, 4096>{};
+        auto size = std::size_t{ 0 };
+        complete_names(p_parameters, get_help_handler(p_context, p_parameters), words, [&](std::string_view p_name) {
+            if (size + p_name.size() + 1 > buffer.size()) {
+                write_fd(p_context.output_fd, std::string_view{ buffer.data(), size }, p_name, "\n");
+                size = 0;
+                return;
+            }
+            std::memcpy(buffer.data() + size, p_name.data(), p_name.size());
+            size += p_name.size();
+            buffer[size++] = '\n';
+        });
+        if (size > 0) {
+            write_fd(p_context.output_fd, std::string_view{ buffer.data(), size }, {}, {});
+        }
+
+        return parse_codes::successful_completion;
+    }
+
+}
+
+namespace cppli {
+
+    // Error.
+    inline error& error::set_callback(const error_callback& p_callback) {
+        callback = p_callback;
+        return *this;
+    }
+    inline error& error::set_callback(error_callback&& p_callback) {
+        callback = std::move(p_callback);
+        return *this;
+    }
+
+
+    // Parse error.
+    inline std::string parse_error::message() const {
+        auto result = std::string{};
+        impl::append_parse_error_message(*this, result);
+        return result;
+    }
+
+    inline std::pmr::string parse_error::message(std::pmr::memory_resource* p_resource) const {
+        auto result = std::pmr::string(p_resource);
+        impl::append_parse_error_message(*this, result);
+        return result;
+    }
+
+    inline std::size_t parse_error::suggestions(std::string_view* p_output, std::size_t p_max_count) const {
+        if (suggestion_function == nullptr) {
+            return 0;
+        }
+        return suggestion_function(suggestion_source, token, p_output, p_max_count);
+    }
+
+    inline parse_error::operator std::string() const {
+        return message();
+    }
+
+
+    // Default error.
+    inline default_error::default_error() :
+        error{ &default_callback }
+    {}
+
+    inline void default_error::default_callback(context&, const parse_error& p_error) {
+        std::cerr << p_error.message() << "\n";
+    }
+
+
+
+    // Help
+    inline bool help::has_names() const {
+        auto it = std::find_if(names.begin(), names.end(),
+            [](const auto& name) { return !name.empty(); });
+
+        return it != names.end();
+    }
+
+    inline bool help::has_name(std::string_view p_name) const {
+        return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
+            return name == p_name;
+        }) != names.end();
+    }
+
+    inline help& help::set_name(const std::string& p_name) {
+        names = { p_name };
+        return *this;
+    }
+    inline help& help::set_name(std::string&& p_name) {
+        names = { std::move(p_name) };
+        return *this;
+    }
+
+    inline help& help::set_names(std::initializer_list<std::string> p_names) {
+        names = p_names;
+        return *this;
+    }
+    inline help& help::set_names(const std::vector<std::string>& p_names) {
+        names = p_names;
+        return *this;
+    }
+    inline help& help::set_names(std::vector<std::string>&& p_names) {
+        names = std::move(p_names);
+        return *this;
+    }
+
+    inline help& help::set_description(const std::string& p_description) {
+        description = p_description;
+        return *this;
+    }
+    inline help& help::set_description(std::string&& p_description) {
+        description = std::move(p_description);
+        return *this;
+    }
+
+    inline help& help::set_callback(const help_callback& p_callback) {
+        callback = p_callback;
+        return *this;
+    }
+    inline help& help::set_callback(help_callback&& p_callback) {
+        callback = std::move(p_callback);
+        return *this;
+    }
+
+
+    // Default help.
+    inline default_help::default_help(std::vector<std::string> names) :
+        help{ std::move(names), "Show command line help.", &default_callback }
+    {}
+
+    inline int default_help::default_callback(context& p_context) {
+        if (p_context.current_parameter_group.has_value()) {
+            const auto& current_parameters = p_context.current_parameter_group.value().get();
+            const auto body = current_parameters.m_help_cache.get(
+                current_parameters,
+                impl::get_help_handler(p_context, current_parameters));
+
+            // Anything the program already streamed to std::cout goes out before the help written past it.
+            std::cout.flush();
+            impl::write_fd(
+                p_context.output_fd,
+                "Usage: ",
+                !p_context.current_path.empty() ? p_context.current_path.back() : std::string_view{},
+                *body);
+        }
+
+        return parse_codes::successful_help;
+    }
+
+    inline std::string default_help::default_string(
+        const context& p_context,
+        const parameters& p_parameters)
+    {
+        auto result = std::string{ "Usage: " };
+        if (!p_context.current_path.empty()) {
+            result += p_context.current_path.back();
+        }
+
+        result += *p_parameters.m_help_cache.get(p_parameters, impl::get_help_handler(p_context, p_parameters));
+        return result;
+    }
+
+    inline std::string default_help::join_names(const std::vector<std::string>& names) {
+        if (names.empty()) {
+            return "";
+        }
+
+        std::string result = names.front();
+        for (auto it = std::next(names.begin()); it != names.end(); ++it) {
+            const auto& name = *it;
+            if (name.empty()) {
+                continue;
+            }
+            result += "|" + name;
+        }
+
+        return result;
+    }
+
+
+    // Completion.
+    inline completion& completion::set_name(const std::string& p_name) {
+        name = p_name;
+        return *this;
+    }
+    inline completion& completion::set_name(std::string&& p_name) {
+        name = std::move(p_name);
+        return *this;
+    }
+
+    inline std::string completion::script(completion_shell p_shell, std::string_view p_program_name) const {
+        auto function_name = std::string{ "_" };
+        function_name.append(p_program_name);
+        std::replace_if(function_name.begin(), function_name.end(), [](const char p_character) {
+            return !std::isalnum(static_cast<unsigned char>(p_character));
+        }, '_');
+        function_name.append("_complete");
+
+        auto result = std::string{};
+        auto append = [&result](std::initializer_list<std::string_view> p_parts) {
+            for (const auto part : p_parts) {
+                result.append(part);
+            }
+        };
+
+        switch (p_shell) {
+            case completion_shell::bash:
+                append({
+                    function_name, "() {\n"
+                    "    local IFS=$'\\n'\n"
+                    "    COMPREPLY=($(\"${COMP_WORDS[0]}\" ", name, " \"${COMP_WORDS[@]:1:COMP_CWORD}\" 2>/dev/null))\n"
+                    "}\n"
+                    "complete -o default -F ", function_name, " ", p_program_name, "\n" });
+                break;
+            case completion_shell::zsh:
+                append({
+                    "#compdef ", p_program_name, "\n\n",
+                    function_name, "() {\n"
+                    "    local -a candidates\n"
+                    "    candidates=(${(f)\"$(\"${words[1]}\" ", name, " \"${(@)words[2,CURRENT]}\" 2>/dev/null)\"})\n"
+                    "    if (( ${#candidates} )); then\n"
+                    "        compadd -a candidates\n"
+                    "    else\n"
+                    "        _files\n"
+                    "    fi\n"
+                    "}\n\n"
+                    "if [ \"$funcstack[1]\" = \"", function_name, "\" ]; then\n"
+                    "    ", function_name, " \"$@\"\n"
+                    "else\n"
+                    "    compdef ", function_name, " ", p_program_name, "\n"
+                    "fi\n" });
+                break;
+            case completion_shell::fish:
+                append({
+                    "function ", function_name, "\n"
+                    "    set -l words (commandline -opc)\n"
+                    "    set -l cur (commandline -ct)\n"
+                    "    $words[1] ", name, " $words[2..-1] \"$cur\" 2>/dev/null\n"
+                    "end\n"
+                    "complete -c ", p_program_name, " -a '(", function_name, ")'\n" });
+                break;
+        }
+
+        return result;
+    }
+
+    inline std::size_t completion::candidates(
+        const parameters& p_parameters,
+        const std::string_view* p_words,
+        std::size_t p_count,
+        std::vector<std::string_view>& p_output)
+    {
+        const auto previous_size = p_output.size();
+        impl::complete_names(p_parameters, nullptr, argument_span{ p_words, p_count }, [&p_output](std::string_view p_name) {
+            p_output.emplace_back(p_name);
+        });
+        return p_output.size() - previous_size;
+    }
+
+
+    // Path stack.
+    inline path_stack::path_stack(std::initializer_list<std::string_view> p_names) {
+        reserve(p_names.size());
+        for (const auto name : p_names) {
+            push_back(name);
+        }
+    }
+
+    inline path_stack::path_stack(std::pmr::memory_resource* p_resource) :
+        m_resource(p_resource != nullptr ? p_resource : std::pmr::get_default_resource())
+    {}
+
+    inline path_stack::path_stack(const path_stack& p_other) :
+        m_resource(p_other.m_resource)
+    {
+        reserve(p_other.m_size);
+        std::copy(p_other.begin(), p_other.end(), m_heap != nullptr ? m_heap : m_inline.data());
+        m_size = p_other.m_size;
+    }
+
+    inline path_stack::path_stack(path_stack&& p_other) noexcept :
+        m_inline(p_other.m_inline),
+        m_heap(std::exchange(p_other.m_heap, nullptr)),
+        m_size(std::exchange(p_other.m_size, 0)),
+        m_capacity(std::exchange(p_other.m_capacity, inline_capacity)),
+        m_resource(p_other.m_resource)
+    {}
+
+    inline path_stack& path_stack::operator = (const path_stack& p_other) {
+        if (this != &p_other) {
+            *this = path_stack{ p_other };
+        }
+        return *this;
+    }
+
+    inline path_stack& path_stack::operator = (path_stack&& p_other) noexcept {
+        if (this != &p_other) {
+            release();
+            m_inline = p_other.m_inline;
+            m_heap = std::exchange(p_other.m_heap, nullptr);
+            m_size = std::exchange(p_other.m_size, 0);
+            m_capacity = std::exchange(p_other.m_capacity, inline_capacity);
+            m_resource = p_other.m_resource;
+        }
+        return *this;
+    }
+
+    inline path_stack::~path_stack() {
+        release();
+    }
+
+    inline bool path_stack::empty() const {
+        return m_size == 0;
+    }
+
+    inline std::size_t path_stack::size() const {
+        return m_size;
+    }
+
+    inline std::size_t path_stack::capacity() const {
+        return m_capacity;
+    }
+
+    inline const std::string_view* path_stack::data() const {
+        return m_heap != nullptr ? m_heap : m_inline.data();
+    }
+
+    inline const std::string_view& path_stack::operator [] (std::size_t p_index) const {
+        return data()[p_index];
+    }
+
+    inline const std::string_view& path_stack::front() const {
+        return data()[0];
+    }
+
+    inline const std::string_view& path_stack::back() const {
+        return data()[m_size - 1];
+    }
+
+    inline const std::string_view* path_stack::begin() const {
+        return data();
+    }
+
+    inline const std::string_view* path_stack::end() const {
+        return data() + m_size;
+    }
+
+    inline void path_stack::push_back(std::string_view p_name) {
+        if (m_size == m_capacity) {
+            reserve(m_capacity * 2);
+        }
+        (m_heap != nullptr ? m_heap : m_inline.data())[m_size++] = p_name;
+    }
+
+    inline void path_stack::emplace_back(std::string_view p_name) {
+        push_back(p_name);
+    }
+
+    inline void path_stack::pop_back() {
+        --m_size;
+    }
+
+    inline void path_stack::clear() {
+        m_size = 0;
+    }
+
+    inline void path_stack::reserve(std::size_t p_capacity) {
+        // Only trees deeper than the inline capacity go to the memory resource.
+        if (p_capacity <= m_capacity) {
+            return;
+        }
+        auto* heap = static_cast<std::string_view*>(m_resource->allocate(p_capacity * sizeof(std::string_view), alignof(std::string_view)));
+        std::uninitialized_copy(begin(), end(), heap);
+        release();
+        m_heap = heap;
+        m_capacity = p_capacity;
+    }
+
+    inline std::pmr::memory_resource* path_stack::resource() const {
+        return m_resource;
+    }
+
+    inline void path_stack::release() {
+        if (m_heap != nullptr) {
+            m_resource->deallocate(m_heap, m_capacity * sizeof(std::string_view), alignof(std::string_view));
+            m_heap = nullptr;
+            m_capacity = inline_capacity;
+        }
+    }
+
+
+    // Context.
+    inline context& context::set_arg(int p_argc, char** p_argv) {
+        argc = p_argc;
+        argv = p_argv;
+        arg_index = 0;
+        tokens = nullptr;
+        return *this;
+    }
+    inline context& context::set_argc(int p_argc) {
+        argc = p_argc;
+        return *this;
+    }
+    inline context& context::set_argv(char** p_argv) {
+        argv = p_argv;
+        arg_index = 0;
+        tokens = nullptr;
+        return *this;
+    }
+
+    inline context& context::set_tokens(const std::string_view* p_tokens, std::size_t p_count) {
+        argc = static_cast<int>(p_count);
+        argv = nullptr;
+        arg_index = 0;
+        tokens = p_tokens;
+        return *this;
+    }
+    inline context& context::set_tokens(const std::vector<std::string_view>& p_tokens) {
+        return set_tokens(p_tokens.data(), p_tokens.size());
+    }
+
+    inline std::string_view context::current_arg() const {
+        if (tokens != nullptr) {
+            return tokens[0];
+        }
+        return argv[0];
+    }
+
+    inline context& context::set_environment(char** p_environment) {
+        environment = p_environment;
+        environment_index.clear();
+        return *this;
+    }
+
+    inline std::optional<std::string_view> context::find_environment(std::string_view p_name) {
+        return environment_index.find(environment, p_name);
+    }
+
+    inline context& context::set_config(const config_file& p_config) {
+        config = &p_config;
+        return *this;
+    }
+
+    inline context& context::set_memory_resource(std::pmr::memory_resource* p_resource) {
+        current_path = path_stack{ p_resource };
+        command_path = path_stack{ p_resource };
+        environment_index.set_memory_resource(p_resource);
+        return *this;
+    }
+
+    inline std::pmr::memory_resource* context::memory_resource() const {
+        return current_path.resource();
+    }
+
+    inline context& context::reset() {
+        // Settings, handlers, environment, config and buffers are kept, only the state of the last parse is cleared.
+        argc = 0;
+        argv = nullptr;
+        current_path.clear();
+        current_parameter_group.reset();
+        arg_index = 0;
+        tokens = nullptr;
+        environment_index.clear();
+        command_path.clear();
+        return *this;
+    }
+
+    inline context& context::set_error(const error& p_error) {
+        error_handler = p_error;
+        return *this;
+    }
+    inline context& context::set_error(error&& p_error) {
+        error_handler = std::move(p_error);
+        return *this;
+    }
+
+    inline context& context::set_help(const help& p_help) {
+        help_handler = p_help;
+        return *this;
+    }
+    inline context& context::set_help(help&& p_help) {
+        help_handler = std::move(p_help);
+        return *this;
+    }
+
+    inline context& context::move_to_next_arg() {
+        if (argc <= 0) {
+            return *this;
+        }
+        --argc;
+        ++arg_index;
+
+        if (tokens != nullptr) {
+            ++tokens;
+            return *this;
+        }
+
+        ++argv;
+        while (argc > 0) {
+            if (argv[0] != nullptr) {
+                break;
+            }
+            --argc;
+            ++argv;
+            ++arg_index;
+        }
+
+        return *this;
+    }
+
+
+    // Argument span.
+    inline argument_span::iterator::iterator(const argument_span& p_span, std::size_t p_index) :
+        m_span(&p_span),
+        m_index(p_index)
+    {}
+
+    inline std::string_view argument_span::iterator::operator * () const {
+        return (*m_span)[m_index];
+    }
+
+    inline argument_span::iterator& argument_span::iterator::operator ++ () {
+        ++m_index;
+        return *this;
+    }
+
+    inline argument_span::iterator argument_span::iterator::operator ++ (int) {
+        auto result = *this;
+        ++m_index;
+        return result;
+    }
+
+    inline bool argument_span::iterator::operator == (const iterator& p_other) const {
+        return m_index == p_other.m_index;
+    }
+
+    inline bool argument_span::iterator::operator != (const iterator& p_other) const {
+        return m_index != p_other.m_index;
+    }
+
+    inline argument_span::argument_span(char** p_argv, std::size_t p_size) :
+        m_argv(p_argv),
+        m_size(p_size)
+    {}
+
+    inline argument_span::argument_span(const std::string_view* p_tokens, std::size_t p_size) :
+        m_tokens(p_tokens),
+        m_size(p_size)
+    {}
+
+    inline std::size_t argument_span::size() const {
+        return m_size;
+    }
+
+    inline bool argument_span::empty() const {
+        return m_size == 0;
+    }
+
+    inline std::string_view argument_span::operator [] (std::size_t p_index) const {
+        if (m_tokens != nullptr) {
+            return m_tokens[p_index];
+        }
+        return m_argv[p_index] != nullptr ? std::string_view{ m_argv[p_index] } : std::string_view{};
+    }
+
+    inline char** argument_span::argv() const {
+        return m_argv;
+    }
+
+    inline const std::string_view* argument_span::tokens() const {
+        return m_tokens;
+    }
+
+    inline argument_span::iterator argument_span::begin() const {
+        return iterator{ *this, 0 };
+    }
+
+    inline argument_span::iterator argument_span::end() const {
+        return iterator{ *this, m_size };
+    }
+
+
+    // Byte size.
+    inline bool byte_size::operator == (const byte_size& p_other) const {
+        return bytes == p_other.bytes;
+    }
+
+    inline bool byte_size::operator != (const byte_size& p_other) const {
+        return bytes != p_other.bytes;
+    }
+
+
+    // Tokenizer.
+    inline bool tokenizer::tokenize(std::string_view p_line) {
+        m_tokens.clear();
+
+        // Unescaped tokens never exceed the line, so the arena is sized once and never moves under the views.
+        if (m_arena_size < p_line.size()) {
+            m_arena = std::make_unique<char[]>(p_line.size());
+            m_arena_size = p_line.size();
+        }
+
+        auto is_space = [](char p_char) {
+            return p_char == ' ' || p_char == '\t' || p_char == '\n' || p_char == '\r';
+        };
+
+        std::size_t arena_used = 0;
+        std::size_t position = 0;
+        while (true) {
+            while (position < p_line.size() && is_space(p_line[position])) {
+                ++position;
+            }
+            if (position >= p_line.size()) {
+                return true;
+            }
+
+            const auto token_begin = position;
+            while (position < p_line.size() && !is_space(p_line[position]) &&
+                p_line[position] != '\'' && p_line[position] != '"' && p_line[position] != '\\')
+            {
+                ++position;
+            }
+
+            if (position >= p_line.size() || is_space(p_line[position])) {
+                m_tokens.push_back(p_line.substr(token_begin, position - token_begin));
+                continue;
+            }
+
+            // Quoting or escapes, unescape into the arena.
+            auto* token_data = m_arena.get() + arena_used;
+            std::memcpy(token_data, p_line.data() + token_begin, position - token_begin);
+            auto token_size = position - token_begin;
+            auto has_quotes = false;
+
+            while (position < p_line.size() && !is_space(p_line[position])) {
+                const auto current = p_line[position++];
+                if (current == '\\') {
+                    if (position >= p_line.size()) {
+                        return false;
+                    }
+                    if (p_line[position] != '\n') {
+                        token_data[token_size++] = p_line[position];
+                    }
+                    ++position;
+                }
+                else if (current == '\'') {
+                    has_quotes = true;
+                    const auto end = p_line.find('\'', position);
+                    if (end == std::string_view::npos) {
+                        return false;
+                    }
+                    std::memcpy(token_data + token_size, p_line.data() + position, end - position);
+                    token_size += end - position;
+                    position = end + 1;
+                }
+                else if (current == '"') {
+                    has_quotes = true;
+                    while (position < p_line.size() && p_line[position] != '"') {
+                        if (p_line[position] == '\\' && position + 1 < p_line.size()) {
+                            const auto next = p_line[position + 1];
+                            if (next == '"' || next == '\\' || next == '$' || next == '`') {
+                                token_data[token_size++] = next;
+                                position += 2;
+                                continue;
+                            }
+                            if (next == '\n') {
+                                position += 2;
+                                continue;
+                            }
+                        }
+                        token_data[token_size++] = p_line[position++];
+                    }
+                    if (position >= p_line.size()) {
+                        return false;
+                    }
+                    ++position;
+                }
+                else {
+                    token_data[token_size++] = current;
+                }
+            }
+
+            // A lone line continuation is not a token, but an empty quoted string is.
+            if (token_size > 0 || has_quotes) {
+                m_tokens.emplace_back(token_data, token_size);
+                arena_used += token_size;
+            }
+        }
+    }
+
+    inline const std::vector<std::string_view>& tokenizer::tokens() const {
+        return m_tokens;
+    }
+
+
+    // Response file expander.
+    inline bool response_file_expander::expand(const context& p_context) {
+        m_tokens.clear();
+        m_used_sources = 0;
+
+        auto current = p_context;
+        if (current.first_arg_is_path && current.arg_index == 0 && current.argc > 0) {
+            m_tokens.push_back(current.current_arg());
+            current.move_to_next_arg();
+        }
+
+        while (current.argc > 0) {
+            const auto argument = current.current_arg();
+            if (argument.size() > 1 && argument.front() == '@') {
+                if (!expand_file(argument.substr(1), 1)) {
+                    return false;
+                }
+            }
+            else {
+                m_tokens.push_back(argument);
+            }
+            current.move_to_next_arg();
         }
+
         return true;
     }
 
-    template<typename T>
-    inline const error* get_error_handler(const context& p_context, const T& p_other) {
-        return p_other.error_handler.has_value() ?
-            &p_other.error_handler.value() :
-            p_context.error_handler.has_value() ?
-                &p_context.error_handler.value() :
-                nullptr;
+    inline const std::vector<std::string_view>& response_file_expander::tokens() const {
+        return m_tokens;
+    }
+
+    inline bool response_file_expander::expand_file(std::string_view p_path, std::size_t p_depth) {
+        if (p_depth > max_depth) {
+            return false;
+        }
+
+        // Sources are kept between expansions, so their arenas and token storage are reused.
+        if (m_used_sources == m_sources.size()) {
+            m_sources.push_back(std::make_unique<source>());
+        }
+        auto& current_source = *m_sources[m_used_sources++];
+
+        if (!current_source.file.open(std::string{ p_path }) ||
+            !current_source.tokenizer.tokenize(current_source.file.content()))
+        {
+            return false;
+        }
+
+        for (const auto token : current_source.tokenizer.tokens()) {
+            if (token.size() > 1 && token.front() == '@') {
+                if (!expand_file(token.substr(1), p_depth + 1)) {
+                    return false;
+                }
+            }
+            else {
+                m_tokens.push_back(token);
+            }
+        }
+
+        return true;
+    }
+
+
+    // Config file.
+    inline bool config_file::load(const std::string& p_path) {
+        m_entries.clear();
+        m_sections.clear();
+        m_error_line = 0;
+        if (!m_file.open(p_path)) {
+            return false;
+        }
+        return parse(m_file.content());
     }
 
-    inline error_callback get_error_callback(const error* p_error) {
-        return p_error ? p_error->callback : [](context&, std::string) {};
+    inline bool config_file::load_string(std::string_view p_content) {
+        m_file.close();
+        m_entries.clear();
+        m_sections.clear();
+        m_error_line = 0;
+        return parse(p_content);
     }
 
-    template<typename T>
-    inline const help* get_help_handler(const context& p_context, const T& p_other) {
-        return p_other.help_handler.has_value() ?
-            &p_other.help_handler.value() :
-            p_context.help_handler.has_value() ?
-                &p_context.help_handler.value() :
-                nullptr;
+    inline std::size_t config_file::error_line() const {
+        return m_error_line;
+    }
+
+    inline const std::vector<config_file::entry>& config_file::entries() const {
+        return m_entries;
+    }
+
+    inline std::optional<std::string_view> config_file::find(const std::string_view* p_path, std::size_t p_depth, std::string_view p_key) const {
+        auto result = std::optional<std::string_view>{};
+        visit_section(p_path, p_depth, [&](const entry& p_entry) {
+            if (p_entry.key == p_key) {
+                result = p_entry.value;
+            }
+        });
+        return result;
+    }
+
+    template<typename TFunction>
+    inline void config_file::visit_section(const std::string_view* p_path, std::size_t p_depth, TFunction&& p_function) const {
+        for (const auto& current_section : m_sections) {
+            if (!section_matches(current_section.name, p_path, p_depth)) {
+                continue;
+            }
+            for (auto i = current_section.first; i < current_section.last; ++i) {
+                p_function(m_entries[i]);
+            }
+        }
     }
 
-    template<typename T>
-    inline set_value_callback create_set_value_callback(T& p_value) {
-        return [&p_value](std::string_view string) mutable {
-            static_assert(!std::is_const_v<T>, "Option value cannot be const.");
-            static_assert(std::is_reference_v<decltype(p_value)>, "Option value must be a reference.");
+    inline bool config_file::parse(std::string_view p_content) {
+        auto trim = [](std::string_view p_string) {
+            auto is_space = [](const char p_character) {
+                return p_character == ' ' || p_character == '\t' || p_character == '\r';
+            };
+            while (!p_string.empty() && is_space(p_string.front())) {
+                p_string.remove_prefix(1);
+            }
+            while (!p_string.empty() && is_space(p_string.back())) {
+                p_string.remove_suffix(1);
+            }
+            return p_string;
+        };
 
-            using type = typename impl::raw_option_type_t<std::decay_t<decltype(p_value)>>;
+        m_entries.reserve(static_cast<std::size_t>(std::count(p_content.begin(), p_content.end(), '\n')) + 1);
+        m_sections.push_back(section{ {}, 0, 0 });
 
-            if constexpr (std::is_same_v<type, bool> == true) {
-                auto string_copy = std::string{ string };
-                std::transform(string_copy.begin(), string_copy.end(), string_copy.begin(), [](const auto c) {
-                    return static_cast<decltype(c)>(std::tolower(static_cast<int>(c)));
-                    });
+        const auto* current = p_content.data();
+        const auto* end = current + p_content.size();
+        std::size_t line_number = 0;
+        while (current < end) {
+            ++line_number;
+            const auto* line_end = static_cast<const char*>(std::memchr(current, '\n', static_cast<std::size_t>(end - current)));
+            line_end = line_end != nullptr ? line_end : end;
+            const auto line = trim(std::string_view{ current, static_cast<std::size_t>(line_end - current) });
+            current = line_end + 1;
 
-                if (string_copy == "true" || string_copy == "1") {
-                    p_value = true;
-                    return true;
-                }
-                if (string_copy == "false" || string_copy == "0") {
-                    p_value = false;
-                    return true;
+            if (line.empty() || line.front() == '#' || line.front() == ';') {
+                continue;
+            }
+
+            if (line.front() == '[') {
+                if (line.back() != ']') {
+                    m_error_line = line_number;
+                    return false;
                 }
+                m_sections.back().last = m_entries.size();
+                m_sections.push_back(section{ trim(line.substr(1, line.size() - 2)), m_entries.size(), m_entries.size() });
+                continue;
+            }
 
+            const auto separator = line.find('=');
+            const auto key = trim(line.substr(0, separator));
+            if (separator == std::string_view::npos || key.empty()) {
+                m_error_line = line_number;
                 return false;
             }
-            else if constexpr (std::is_integral_v<type> == true || std::is_floating_point_v<type> == true) {
-                type value{};
-                const auto result = std::from_chars(string.data(), string.data() + string.size(), value).ec == std::errc();
-                if (result) {
-                    p_value = value;
+
+            auto value = trim(line.substr(separator + 1));
+            if (!value.empty() && (value.front() == '"' || value.front() == '\'')) {
+                const auto closing = value.find(value.front(), 1);
+                if (closing == std::string_view::npos) {
+                    m_error_line = line_number;
+                    return false;
                 }
-                return result;
+                value = value.substr(1, closing - 1);
             }
-            else {
-                p_value = string;
-                return true;
+            else if (const auto comment = value.find(" #"); comment != std::string_view::npos) {
+                value = trim(value.substr(0, comment));
             }
-        };
+
+            m_entries.push_back(entry{ m_sections.back().name, key, value, line_number });
+        }
+
+        m_sections.back().last = m_entries.size();
+        return true;
     }
 
-    template<typename T>
-    inline set_flag_callback create_set_flag_callback(T& p_value) {
-        return [&p_value]() mutable {
-            static_assert(!std::is_const_v<T>, "Option value cannot be const.");
-            static_assert(std::is_reference_v<decltype(p_value)>, "Option value must be a reference.");
+    inline bool config_file::section_matches(std::string_view p_section, const std::string_view* p_path, std::size_t p_depth) {
+        // Nested command sections are dotted paths, like [remote.add].
+        for (std::size_t i = 0; i < p_depth; ++i) {
+            const auto separator = p_section.find('.');
+            if (p_section.substr(0, separator) != p_path[i]) {
+                return false;
+            }
+            if (separator == std::string_view::npos) {
+                return i + 1 == p_depth;
+            }
+            p_section.remove_prefix(separator + 1);
+        }
+        return p_section.empty();
+    }
 
-            using type = typename impl::raw_option_type_t<std::decay_t<decltype(p_value)>>;
 
-            p_value = static_cast<type>(true);
-        };
+    // Command.
+    inline bool command::has_name(std::string_view p_name) const {
+        return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
+            return name == p_name;
+        }) != names.end();
     }
 
-}
+    inline command& command::set_name(const std::string& p_name) {
+        names = { p_name };
+        return *this;
+    }
+    inline command& command::set_name(std::string&& p_name) {
+        names = { std::move(p_name) };
+        return *this;
+    }
 
-namespace cppli {
+    inline command& command::set_names(std::initializer_list<std::string> p_names) {
+        names = p_names;
+        return *this;
+    }
+    inline command& command::set_names(const std::vector<std::string>& p_names) {
+        names = p_names;
+        return *this;
+    }
+    inline command& command::set_names(std::vector<std::string>&& p_names) {
+        names = std::move(p_names);
+        return *this;
+    }
 
-    // Error.
-    inline error& error::set_callback(const error_callback& p_callback) {
-        callback = p_callback;
+    inline command& command::set_description(const std::string& p_description) {
+        description = p_description;
         return *this;
     }
-    inline error& error::set_callback(error_callback&& p_callback) {
+    inline command& command::set_description(std::string&& p_description) {
+        description = std::move(p_description);
+        return *this;
+    }
+
+    inline command& command::set_callback(const command_callback& p_callback) {
         callback = p_callback;
         return *this;
     }
+    inline command& command::set_callback(command_callback&& p_callback) {
+        callback = std::move(p_callback);
+        return *this;
+    }
 
+    inline command& command::set_child_parameters(parameters p_parameters) {
+        child_parameters = std::make_shared<const parameters>(std::move(p_parameters));
+        return *this;
+    }
+    inline command& command::set_child_parameters(std::shared_ptr<const parameters> p_parameters) {
+        child_parameters = std::move(p_parameters);
+        return *this;
+    }
 
-    // Default error.
-    inline default_error::default_error() :
-        error{ &default_callback }
-    {}
 
-    inline void default_error::default_callback(context&, std::string p_message) {
-        std::cerr << p_message << "\n";
+    // Option.
+    template<typename T>
+    inline option<T>& option<T>::set_name(const std::string& p_name) {
+        names = { p_name };
+        return *this;
+    }
+    template<typename T>
+    inline option<T>& option<T>::set_name(std::string&& p_name) {
+        names = { std::move(p_name) };
+        return *this;
     }
 
+    template<typename T>
+    inline option<T>& option<T>::set_names(std::initializer_list<std::string> p_names) {
+        names = p_names;
+        return *this;
+    }
+    template<typename T>
+    inline option<T>& option<T>::set_names(const std::vector<std::string>& p_names) {
+        names = p_names;
+        return *this;
+    }
+    template<typename T>
+    inline option<T>& option<T>::set_names(std::vector<std::string>&& p_names) {
+        names = std::move(p_names);
+        return *this;
+    }
 
+    template<typename T>
+    inline option<T>& option<T>::set_description(const std::string& p_description) {
+        description = p_description;
+        return *this;
+    }
+    template<typename T>
+    inline option<T>& option<T>::set_description(std::string&& p_description) {
+        description = std::move(p_description);
+        return *this;
+    }
 
-    // Help
-    inline bool help::has_names() const {
-        auto it = std::find_if(names.begin(), names.end(),
-            [](const auto& name) { return !name.empty(); });
-
-        return it != names.end();
+    template<typename T>
+    inline option<T>& option<T>::set_environment(const std::string& p_environment) {
+        environment = p_environment;
+        return *this;
+    }
+    template<typename T>
+    inline option<T>& option<T>::set_environment(std::string&& p_environment) {
+        environment = std::move(p_environment);
+        return *this;
     }
 
-    inline bool help::has_name(std::string_view p_name) const {
+
+    // Option proxy.
+    template<typename T>
+    inline option_proxy::option_proxy(const option<T>& p_option) :
+        names(p_option.names),
+        description(p_option.description),
+        environment(p_option.environment),
+        m_set_value_callback(impl::create_set_value_callback<T>(p_option.value))
+    {}
+
+    template<typename T>
+    inline option_proxy::option_proxy(option<T>&& p_option) :
+        names(std::move(p_option.names)),
+        description(std::move(p_option.description)),
+        environment(std::move(p_option.environment)),
+        m_set_value_callback(impl::create_set_value_callback<T>(p_option.value))
+    {}
+
+    inline bool option_proxy::has_name(std::string_view p_name) const {
         return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
             return name == p_name;
         }) != names.end();
     }
 
-    inline help& help::set_name(const std::string& p_name) {
+    inline bool option_proxy::has_names() const {
+        return std::find_if(names.begin(), names.end(), [](const auto& name) {
+            return !name.empty(); 
+        }) != names.end();
+    }
+
+    inline bool option_proxy::set_value(std::string_view p_value) const {
+        if (!m_set_value_callback) {
+            return false;
+        }
+        return m_set_value_callback(p_value);
+    }
+
+    // Option flag.
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_name(const std::string& p_name) {
         names = { p_name };
         return *this;
     }
-    inline help& help::set_name(std::string&& p_name) {
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_name(std::string&& p_name) {
         names = { std::move(p_name) };
         return *this;
     }
 
-    inline help& help::set_names(std::initializer_list<std::string> p_names) {
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_names(std::initializer_list<std::string> p_names) {
         names = p_names;
         return *this;
     }
-    inline help& help::set_names(const std::vector<std::string>& p_names) {
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_names(const std::vector<std::string>& p_names) {
         names = p_names;
         return *this;
     }
-    inline help& help::set_names(std::vector<std::string>&& p_names) {
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_names(std::vector<std::string>&& p_names) {
         names = std::move(p_names);
         return *this;
     }
 
-    inline help& help::set_description(const std::string& p_description) {
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_description(const std::string& p_description) {
         description = p_description;
         return *this;
     }
-    inline help& help::set_description(std::string&& p_description) {
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_description(std::string&& p_description) {
         description = std::move(p_description);
         return *this;
     }
 
-    inline help& help::set_callback(const help_callback& p_callback) {
-        callback = p_callback;
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_environment(const std::string& p_environment) {
+        environment = p_environment;
         return *this;
     }
-    inline help& help::set_callback(help_callback&& p_callback) {
-        callback = std::move(p_callback);
+    template<typename T>
+    inline option_flag<T>& option_flag<T>::set_environment(std::string&& p_environment) {
+        environment = std::move(p_environment);
         return *this;
     }
 
 
-    // Default help.
-    inline default_help::default_help(std::vector<std::string> names) :
-        help{ std::move(names), "Show command line help.", &default_callback }
+    // Rest arguments.
+    inline rest_arguments::rest_arguments(argument_span& p_value, std::string p_name) :
+        value(&p_value),
+        name(std::move(p_name))
     {}
 
-    inline int default_help::default_callback(context& p_context) {
-        if (p_context.current_parameter_group.has_value()) {
-            std::cout << default_string(
-                p_context,
-                p_context.current_parameter_group.value());
-        }
-
-        return parse_codes::successful_help;
+    inline rest_arguments& rest_arguments::set_name(const std::string& p_name) {
+        name = p_name;
+        return *this;
+    }
+    inline rest_arguments& rest_arguments::set_name(std::string&& p_name) {
+        name = std::move(p_name);
+        return *this;
     }
 
-    inline std::string default_help::default_string(
-        const context& p_context,
-        const parameters& p_parameters)
-    {
-        auto result = std::string{ "Usage: " };
-        if (!p_context.current_path.empty()) {
-            result += p_context.current_path.back();
-        }
 
-        auto* help_handler = impl::get_help_handler(p_context, p_parameters);
+    // Option flag proxy.
+    template<typename T>
+    inline option_flag_proxy::option_flag_proxy(const option_flag<T>& p_option_flag) :
+        names(p_option_flag.names),
+        description(p_option_flag.description),
+        environment(p_option_flag.environment),
+        m_set_flag_callback(impl::create_set_flag_callback<T>(p_option_flag.value))
+    {}
 
-        const size_t pre_option_count =
-            p_parameters.required_options.size() +
-            p_parameters.optional_options.size() +
-            p_parameters.flag_options.size() +
-            ((help_handler && help_handler->has_names()) ? size_t{ 1 } : size_t{ 0 });
+    template<typename T>
+    inline option_flag_proxy::option_flag_proxy(option_flag<T>&& p_option_flag) :
+        names(std::move(p_option_flag.names)),
+        description(std::move(p_option_flag.description)),
+        environment(std::move(p_option_flag.environment)),
+        m_set_flag_callback(impl::create_set_flag_callback<T>(p_option_flag.value))
+    {}
 
-        const size_t pre_command_count = p_parameters.commands.size();
+    inline bool option_flag_proxy::has_name(std::string_view p_name) const {
+        return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
+            return name == p_name;
+        }) != names.end();
+    }
+    
+    inline bool option_flag_proxy::has_names() const {
+        return std::find_if(names.begin(), names.end(), [](const auto& name) {
+            return !name.empty();
+        }) != names.end();
+    }
 
-        if (pre_option_count == 0 && pre_command_count == 0) {
-            return result;
+    inline bool option_flag_proxy::set_flag() const {
+        if (!m_set_flag_callback) {
+            return false;
         }
+        m_set_flag_callback();
+        return true;
+    }
 
-        size_t min_command_column = 0;
-        std::vector<std::pair<std::string, std::string>> option_rows = {};
-        std::vector<std::pair<std::string, std::string>> command_rows = {};
-        option_rows.reserve(pre_option_count);
-        command_rows.reserve(pre_command_count);
-
-        auto add_row = [&](
-            std::vector<std::pair<std::string, std::string>>& p_container,
-            const std::vector<std::string>& p_names, 
-            const std::string& p_description)
-        {
-            const std::string name = join_names(p_names);
-            if (name.empty()) {
-                return;
-            }
-            p_container.emplace_back(name, p_description);
-            min_command_column = std::max(min_command_column, name.size());
-        };
-
-        auto add_option_row = [&](const std::vector<std::string>& p_names, const std::string& p_description) {
-            add_row(option_rows, p_names, p_description);
-        };
-        auto add_command_row = [&](const std::vector<std::string>& p_names, const std::string& p_description) {
-            add_row(command_rows, p_names, p_description);
-        };
 
-        if (help_handler) {
-            if (pre_command_count > 0) {
-                add_command_row(help_handler->names, help_handler->description);
-            }
-            else {
-                add_option_row(help_handler->names, help_handler->description);
+    // Parameters.
+    inline int parameters::parse(context& p_context) const {
+        if (completion_handler.has_value()) {
+            if (const auto result = impl::parse_completion(p_context, *this, completion_handler.value()); result.has_value()) {
+                return result.value();
             }
         }
-        for (const auto& option : p_parameters.required_options) {
-            add_option_row(option.names, option.description);
+        p_context.environment_index.clear();
+        return impl::parse_command_tree(p_context, *this, nullptr);
+    }
 
-            if (option.has_names()) {
-                result += " <" + option.names.front() + ">";
-            }        
-        }
-        for (const auto& option : p_parameters.optional_options) {
-            add_option_row(option.names, option.description);
-        }
-        for (const auto& option : p_parameters.flag_options) {
-            add_option_row(option.names, option.description);
+    template<typename T>
+    inline parameters& parameters::add_option(const option<T>& p_option) {
+        if constexpr (impl::is_optional_option_v<T> == true) {
+            optional_options.emplace_back(p_option);
+            m_lookup_index.add_item(impl::name_kind::optional, optional_options.back().names, *this);
+            add_environment_item(impl::name_kind::optional, optional_options.size() - 1, optional_options.back().environment);
         }
-        for (const auto& command : p_parameters.commands) {
-            add_command_row(command.names, command.description);
+        else {
+            required_options.emplace_back(p_option);
         }
+        m_help_cache.invalidate();
 
-        if (option_rows.size() > 0) {
-            result += " [options]";
+        return *this;
+    }
+    template<typename T>
+    inline parameters& parameters::add_option(option<T>&& p_option) {
+        if constexpr (impl::is_optional_option_v<T> == true) {
+            optional_options.emplace_back(p_option);
+            m_lookup_index.add_item(impl::name_kind::optional, optional_options.back().names, *this);
+            add_environment_item(impl::name_kind::optional, optional_options.size() - 1, optional_options.back().environment);
         }
-        if (command_rows.size() > 0) {
-            result += " [command] [command-options]";
+        else {
+            required_options.emplace_back(p_option);
         }
+        m_help_cache.invalidate();
+        return *this;
+    }
+
+    template<typename T>
+    inline parameters& parameters::add_option(const option_flag<T>& p_option_flag) {
+        flag_options.emplace_back(p_option_flag);
+        m_lookup_index.add_item(impl::name_kind::flag, flag_options.back().names, *this);
+        add_environment_item(impl::name_kind::flag, flag_options.size() - 1, flag_options.back().environment);
+        m_help_cache.invalidate();
+        return *this;
+    }
+    template<typename T>
+    inline parameters& parameters::add_option(option_flag<T>&& p_option_flag) {
+        flag_options.emplace_back(p_option_flag);
+        m_lookup_index.add_item(impl::name_kind::flag, flag_options.back().names, *this);
+        add_environment_item(impl::name_kind::flag, flag_options.size() - 1, flag_options.back().environment);
+        m_help_cache.invalidate();
+        return *this;
+    }
+
+    inline parameters& parameters::add_command(const command& p_command) {
+        commands.emplace_back(p_command);
+        m_lookup_index.add_item(impl::name_kind::command, commands.back().names, *this);
+        m_help_cache.invalidate();
+        return *this;
+    }
+    inline parameters& parameters::add_command(command&& p_command) {
+        commands.emplace_back(std::move(p_command));
+        m_lookup_index.add_item(impl::name_kind::command, commands.back().names, *this);
+        m_help_cache.invalidate();
+        return *this;
+    }
 
-        result += "\n";
+    inline parameters& parameters::add_parameters(parameters&& p_parameters) {
+        const auto optional_option_count = optional_options.size();
+        const auto flag_option_count = flag_options.size();
+        const auto command_count = commands.size();
+
+        auto append = [](auto& p_target, auto& p_source) {
+            p_target.insert(
+                p_target.end(),
+                std::make_move_iterator(p_source.begin()),
+                std::make_move_iterator(p_source.end()));
+            p_source.clear();
+        };
+        append(required_options, p_parameters.required_options);
+        append(optional_options, p_parameters.optional_options);
+        append(flag_options, p_parameters.flag_options);
+        append(commands, p_parameters.commands);
 
-        if (option_rows.size() > 0) {
-            result += "\nOptions:\n";
+        if (!error_handler.has_value() && p_parameters.error_handler.has_value()) {
+            error_handler = std::move(p_parameters.error_handler);
+        }
 
-            for (const auto& option_row : option_rows) {
-                const auto& [name, description] = option_row;
-                result += "  " + name;
-                const size_t tab_width = min_command_column - name.size() + size_t{ 6 };
-                result += std::string(tab_width, ' ');
-                result += description + "\n";
-            }
+        if (!help_handler.has_value() && p_parameters.help_handler.has_value()) {
+            help_handler = std::move(p_parameters.help_handler);
         }
-       
-        if (command_rows.size() > 0) {
-            result += "\nCommands:\n";
 
-            for (const auto& command_row : command_rows) {
-                const auto& [name, description] = command_row;
-                result += "  " + name;
-                const size_t tab_width = min_command_column - name.size() + size_t{ 6 };
-                result += std::string(tab_width, ' ');
-                result += description + "\n";
-            }
+        if (!completion_handler.has_value() && p_parameters.completion_handler.has_value()) {
+            completion_handler = std::move(p_parameters.completion_handler);
         }
 
-        return result;
+        if (!rest_handler.has_value() && p_parameters.rest_handler.has_value()) {
+            rest_handler = std::move(p_parameters.rest_handler);
+        }
+
+        allow_abbreviations = allow_abbreviations || p_parameters.allow_abbreviations;
+
+        return index_appended(optional_option_count, flag_option_count, command_count);
     }
+    inline parameters& parameters::add_parameters(const parameters& p_parameters) {
+        const auto optional_option_count = optional_options.size();
+        const auto flag_option_count = flag_options.size();
+        const auto command_count = commands.size();
 
-    inline std::string default_help::join_names(const std::vector<std::string>& names) {
-        if (names.empty()) {
-            return "";
+        auto append = [](auto& p_target, const auto& p_source) {
+            p_target.insert(p_target.end(), p_source.begin(), p_source.end());
+        };
+        append(required_options, p_parameters.required_options);
+        append(optional_options, p_parameters.optional_options);
+        append(flag_options, p_parameters.flag_options);
+        append(commands, p_parameters.commands);
+
+        if (!error_handler.has_value() && p_parameters.error_handler.has_value()) {
+            error_handler = p_parameters.error_handler;
         }
 
-        std::string result = names.front();
-        for (auto it = std::next(names.begin()); it != names.end(); ++it) {
-            const auto& name = *it;
-            if (name.empty()) {
-                continue;
-            }
-            result += "|" + name;
+        if (!help_handler.has_value() && p_parameters.help_handler.has_value()) {
+            help_handler = p_parameters.help_handler;
         }
 
-        return result;
-    }
+        if (!completion_handler.has_value() && p_parameters.completion_handler.has_value()) {
+            completion_handler = p_parameters.completion_handler;
+        }
 
+        if (!rest_handler.has_value() && p_parameters.rest_handler.has_value()) {
+            rest_handler = p_parameters.rest_handler;
+        }
 
-    // Context.
-    inline context& context::set_arg(int p_argc, char** p_argv) {
-        argc = p_argc;
-        argv = p_argv;
-        return *this;
-    }
-    inline context& context::set_argc(int p_argc) {
-        argc = p_argc;
-        return *this;
-    }
-    inline context& context::set_argv(char** p_argv) {
-        argv = p_argv;
-        return *this;
+        allow_abbreviations = allow_abbreviations || p_parameters.allow_abbreviations;
+
+        return index_appended(optional_option_count, flag_option_count, command_count);
     }
 
-    inline context& context::set_error(const error& p_error) {
+    inline parameters& parameters::set_error(const error& p_error) {
         error_handler = p_error;
         return *this;
     }
-    inline context& context::set_error(error&& p_error) {
+    inline parameters& parameters::set_error(error&& p_error) {
         error_handler = std::move(p_error);
         return *this;
     }
 
-    inline context& context::set_help(const help& p_help) {
+    inline parameters& parameters::set_help(const help& p_help) {
         help_handler = p_help;
+        m_help_cache.invalidate();
         return *this;
     }
-    inline context& context::set_help(help&& p_help) {
+    inline parameters& parameters::set_help(help&& p_help) {
         help_handler = std::move(p_help);
+        m_help_cache.invalidate();
         return *this;
     }
 
-    inline context& context::move_to_next_arg() {
-        if (argc <= 0) {
-            return *this;
-        }
-        first_arg_is_path = false;
-        --argc;
-        ++argv;
-
-        while (argc > 0) {
-            if (argv[0] != nullptr) {
-                break;
-            }
-            --argc;
-            ++argv;
-        }
-
+    inline parameters& parameters::set_completion(const completion& p_completion) {
+        completion_handler = p_completion;
         return *this;
     }
-
-
-    // Command.
-    inline bool command::has_name(std::string_view p_name) const {
-        return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
-            return name == p_name;
-        }) != names.end();
+    inline parameters& parameters::set_completion(completion&& p_completion) {
+        completion_handler = std::move(p_completion);
+        return *this;
     }
 
-    inline command& command::set_name(const std::string& p_name) {
-        names = { p_name };
+    inline parameters& parameters::set_rest_arguments(const rest_arguments& p_rest_arguments) {
+        rest_handler = p_rest_arguments;
+        m_help_cache.invalidate();
         return *this;
     }
-    inline command& command::set_name(std::string&& p_name) {
-        names = { std::move(p_name) };
+    inline parameters& parameters::set_rest_arguments(rest_arguments&& p_rest_arguments) {
+        rest_handler = std::move(p_rest_arguments);
+        m_help_cache.invalidate();
         return *this;
     }
 
-    inline command& command::set_names(std::initializer_list<std::string> p_names) {
-        names = p_names;
-        return *this;
-    }
-    inline command& command::set_names(const std::vector<std::string>& p_names) {
-        names = p_names;
+    inline parameters& parameters::set_abbreviations(bool p_allow) {
+        allow_abbreviations = p_allow;
         return *this;
     }
-    inline command& command::set_names(std::vector<std::string>&& p_names) {
-        names = std::move(p_names);
-        return *this;
+
+    inline const option_flag_proxy* parameters::find_flag(std::string_view p_name) const {
+        if (!m_lookup_index.covers(impl::name_kind::flag, flag_options.size())) {
+            return impl::find_by_name(flag_options, p_name);
+        }
+        const auto item = m_lookup_index.find(impl::name_kind::flag, p_name, *this);
+        return item != impl::name_index::npos ? &flag_options[item] : nullptr;
     }
 
-    inline command& command::set_description(const std::string& p_description) {
-        description = p_description;
-        return *this;
+    inline const option_proxy* parameters::find_optional(std::string_view p_name) const {
+        if (!m_lookup_index.covers(impl::name_kind::optional, optional_options.size())) {
+            return impl::find_by_name(optional_options, p_name);
+        }
+        const auto item = m_lookup_index.find(impl::name_kind::optional, p_name, *this);
+        return item != impl::name_index::npos ? &optional_options[item] : nullptr;
     }
-    inline command& command::set_description(std::string&& p_description) {
-        description = std::move(p_description);
+
+    inline const command* parameters::find_command(std::string_view p_name) const {
+        if (!m_lookup_index.covers(impl::name_kind::command, commands.size())) {
+            return impl::find_by_name(commands, p_name);
+        }
+        const auto item = m_lookup_index.find(impl::name_kind::command, p_name, *this);
+        return item != impl::name_index::npos ? &commands[item] : nullptr;
+    }
+
+    inline parameters& parameters::rebuild_index() {
+        m_lookup_index.clear();
+        m_abbreviation_index.clear();
+        m_help_cache.invalidate();
+        m_environment_items.clear();
+        for (std::size_t i = 0; i < flag_options.size(); ++i) {
+            m_lookup_index.add_item(impl::name_kind::flag, flag_options[i].names, *this);
+            add_environment_item(impl::name_kind::flag, i, flag_options[i].environment);
+        }
+        for (std::size_t i = 0; i < optional_options.size(); ++i) {
+            m_lookup_index.add_item(impl::name_kind::optional, optional_options[i].names, *this);
+            add_environment_item(impl::name_kind::optional, i, optional_options[i].environment);
+        }
+        for (const auto& command : commands) {
+            m_lookup_index.add_item(impl::name_kind::command, command.names, *this);
+        }
         return *this;
     }
 
-    inline command& command::set_callback(const command_callback& p_callback) {
-        callback = p_callback;
+    inline parameters& parameters::index_appended(std::size_t p_optional_option_offset, std::size_t p_flag_option_offset, std::size_t p_command_offset) {
+        m_help_cache.invalidate();
+
+        // An index that is already stale is rebuilt in full, otherwise only the appended items are added.
+        if (!m_lookup_index.covers(impl::name_kind::optional, p_optional_option_offset) ||
+            !m_lookup_index.covers(impl::name_kind::flag, p_flag_option_offset) ||
+            !m_lookup_index.covers(impl::name_kind::command, p_command_offset))
+        {
+            return rebuild_index();
+        }
+
+        for (auto i = p_flag_option_offset; i < flag_options.size(); ++i) {
+            m_lookup_index.add_item(impl::name_kind::flag, flag_options[i].names, *this);
+            add_environment_item(impl::name_kind::flag, i, flag_options[i].environment);
+        }
+        for (auto i = p_optional_option_offset; i < optional_options.size(); ++i) {
+            m_lookup_index.add_item(impl::name_kind::optional, optional_options[i].names, *this);
+            add_environment_item(impl::name_kind::optional, i, optional_options[i].environment);
+        }
+        for (auto i = p_command_offset; i < commands.size(); ++i) {
+            m_lookup_index.add_item(impl::name_kind::command, commands[i].names, *this);
+        }
         return *this;
     }
-    inline command& command::set_callback(command_callback&& p_callback) {
-        callback = std::move(p_callback);
-        return *this;
+
+    inline void parameters::add_environment_item(impl::name_kind p_kind, std::size_t p_index, const std::string& p_environment) {
+        if (!p_environment.empty()) {
+            m_environment_items.emplace_back(p_kind, p_index);
+        }
     }
 
+    inline const std::string* parameters::indexed_name(impl::name_kind p_kind, std::size_t p_item, std::size_t p_alias) const {
+        auto get_name = [&](const auto& p_items) -> const std::string* {
+            if (p_item >= p_items.size() || p_alias >= p_items[p_item].names.size()) {
+                return nullptr;
+            }
+            return &p_items[p_item].names[p_alias];
+        };
 
-    // Option.
-    template<typename T>
-    inline option<T>& option<T>::set_name(const std::string& p_name) {
-        names = { p_name };
-        return *this;
+        switch (p_kind) {
+            case impl::name_kind::flag: return get_name(flag_options);
+            case impl::name_kind::optional: return get_name(optional_options);
+            case impl::name_kind::command: return get_name(commands);
+            case impl::name_kind::required: return get_name(required_options);
+        }
+        return nullptr;
     }
-    template<typename T>
-    inline option<T>& option<T>::set_name(std::string&& p_name) {
-        names = { std::move(p_name) };
-        return *this;
+
+
+    inline compiled_parameters parameters::compile(std::pmr::memory_resource* p_resource) const {
+        return compiled_parameters{ *this, p_resource };
     }
 
-    template<typename T>
-    inline option<T>& option<T>::set_names(std::initializer_list<std::string> p_names) {
-        names = p_names;
+
+    // Parameters builder.
+    inline parameters_builder& parameters_builder::reserve(
+        std::size_t p_required_option_count,
+        std::size_t p_optional_option_count,
+        std::size_t p_flag_option_count,
+        std::size_t p_command_count)
+    {
+        m_parameters.required_options.reserve(p_required_option_count);
+        m_parameters.optional_options.reserve(p_optional_option_count);
+        m_parameters.flag_options.reserve(p_flag_option_count);
+        m_parameters.commands.reserve(p_command_count);
         return *this;
     }
+
     template<typename T>
-    inline option<T>& option<T>::set_names(const std::vector<std::string>& p_names) {
-        names = p_names;
+    inline parameters_builder& parameters_builder::add_option(const option<T>& p_option) {
+        if constexpr (impl::is_optional_option_v<T> == true) {
+            m_parameters.optional_options.emplace_back(p_option);
+        }
+        else {
+            m_parameters.required_options.emplace_back(p_option);
+        }
         return *this;
     }
     template<typename T>
-    inline option<T>& option<T>::set_names(std::vector<std::string>&& p_names) {
-        names = std::move(p_names);
+    inline parameters_builder& parameters_builder::add_option(option<T>&& p_option) {
+        if constexpr (impl::is_optional_option_v<T> == true) {
+            m_parameters.optional_options.emplace_back(std::move(p_option));
+        }
+        else {
+            m_parameters.required_options.emplace_back(std::move(p_option));
+        }
         return *this;
     }
 
     template<typename T>
-    inline option<T>& option<T>::set_description(const std::string& p_description) {
-        description = p_description;
+    inline parameters_builder& parameters_builder::add_option(const option_flag<T>& p_option_flag) {
+        m_parameters.flag_options.emplace_back(p_option_flag);
         return *this;
     }
     template<typename T>
-    inline option<T>& option<T>::set_description(std::string&& p_description) {
-        description = std::move(p_description);
+    inline parameters_builder& parameters_builder::add_option(option_flag<T>&& p_option_flag) {
+        m_parameters.flag_options.emplace_back(std::move(p_option_flag));
         return *this;
     }
 
-
-    // Option proxy.
-    template<typename T>
-    inline option_proxy::option_proxy(const option<T>& p_option) :
-        names(p_option.names),
-        description(p_option.description),
-        m_set_value_callback(impl::create_set_value_callback<T>(p_option.value))
-    {}
-
-    template<typename T>
-    inline option_proxy::option_proxy(option<T>&& p_option) :
-        names(std::move(p_option.names)),
-        description(std::move(p_option.description)),
-        m_set_value_callback(impl::create_set_value_callback<T>(p_option.value))
-    {}
-
-    inline bool option_proxy::has_name(std::string_view p_name) const {
-        return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
-            return name == p_name;
-        }) != names.end();
-    }
-
-    inline bool option_proxy::has_names() const {
-        return std::find_if(names.begin(), names.end(), [](const auto& name) {
-            return !name.empty(); 
-        }) != names.end();
+    inline parameters_builder& parameters_builder::add_command(const command& p_command) {
+        m_parameters.commands.emplace_back(p_command);
+        return *this;
     }
-
-    inline bool option_proxy::set_value(std::string_view p_value) const {
-        if (!m_set_value_callback) {
-            return false;
-        }
-        return m_set_value_callback(p_value);
+    inline parameters_builder& parameters_builder::add_command(command&& p_command) {
+        m_parameters.commands.emplace_back(std::move(p_command));
+        return *this;
     }
 
-    // Option flag.
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_name(const std::string& p_name) {
-        names = { p_name };
+    inline parameters_builder& parameters_builder::set_error(const error& p_error) {
+        m_parameters.error_handler = p_error;
         return *this;
     }
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_name(std::string&& p_name) {
-        names = { std::move(p_name) };
+    inline parameters_builder& parameters_builder::set_error(error&& p_error) {
+        m_parameters.error_handler = std::move(p_error);
         return *this;
     }
 
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_names(std::initializer_list<std::string> p_names) {
-        names = p_names;
+    inline parameters_builder& parameters_builder::set_help(const help& p_help) {
+        m_parameters.help_handler = p_help;
         return *this;
     }
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_names(const std::vector<std::string>& p_names) {
-        names = p_names;
+    inline parameters_builder& parameters_builder::set_help(help&& p_help) {
+        m_parameters.help_handler = std::move(p_help);
+        return *this;
+    }
+
+    inline parameters_builder& parameters_builder::set_completion(const completion& p_completion) {
+        m_parameters.completion_handler = p_completion;
         return *this;
     }
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_names(std::vector<std::string>&& p_names) {
-        names = std::move(p_names);
+    inline parameters_builder& parameters_builder::set_completion(completion&& p_completion) {
+        m_parameters.completion_handler = std::move(p_completion);
         return *this;
     }
 
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_description(const std::string& p_description) {
-        description = p_description;
+    inline parameters_builder& parameters_builder::set_rest_arguments(const rest_arguments& p_rest_arguments) {
+        m_parameters.rest_handler = p_rest_arguments;
         return *this;
     }
-    template<typename T>
-    inline option_flag<T>& option_flag<T>::set_description(std::string&& p_description) {
-        description = std::move(p_description);
+    inline parameters_builder& parameters_builder::set_rest_arguments(rest_arguments&& p_rest_arguments) {
+        m_parameters.rest_handler = std::move(p_rest_arguments);
         return *this;
     }
 
-
-    // Option flag proxy.
-    template<typename T>
-    inline option_flag_proxy::option_flag_proxy(const option_flag<T>& p_option_flag) :
-        names(p_option_flag.names),
-        description(p_option_flag.description),
-        m_set_flag_callback(impl::create_set_flag_callback<T>(p_option_flag.value))
-    {}
-
-    template<typename T>
-    inline option_flag_proxy::option_flag_proxy(option_flag<T>&& p_option_flag) :
-        names(std::move(p_option_flag.names)),
-        description(std::move(p_option_flag.description)),
-        m_set_flag_callback(impl::create_set_flag_callback<T>(p_option_flag.value))
-    {}
-
-    inline bool option_flag_proxy::has_name(std::string_view p_name) const {
-        return std::find_if(names.begin(), names.end(), [p_name](const auto& name) {
-            return name == p_name;
-        }) != names.end();
-    }
-    
-    inline bool option_flag_proxy::has_names() const {
-        return std::find_if(names.begin(), names.end(), [](const auto& name) {
-            return !name.empty();
-        }) != names.end();
+    inline parameters_builder& parameters_builder::set_abbreviations(bool p_allow) {
+        m_parameters.allow_abbreviations = p_allow;
+        return *this;
     }
 
-    inline bool option_flag_proxy::set_flag() const {
-        if (!m_set_flag_callback) {
-            return false;
+    inline parameters parameters_builder::build() {
+        // Names are indexed once, into a table sized for all of them.
+        auto name_count = size_t{ 0 };
+        for (const auto& option : m_parameters.optional_options) {
+            name_count += option.names.size();
+        }
+        for (const auto& option : m_parameters.flag_options) {
+            name_count += option.names.size();
+        }
+        for (const auto& command : m_parameters.commands) {
+            name_count += command.names.size();
         }
-        m_set_flag_callback();
-        return true;
-    }
 
+        m_parameters.m_lookup_index.clear();
+        m_parameters.m_lookup_index.reserve(name_count);
+        m_parameters.rebuild_index();
 
-    // Parameters.
-    inline int parameters::parse(context& p_context) const {
-        p_context.current_parameter_group = *this;
+        auto result = std::move(m_parameters);
+        m_parameters = {};
+        return result;
+    }
 
-        auto* current_help_handler = impl::get_help_handler(p_context, *this);
-        auto* current_error_handler = impl::get_error_handler(p_context, *this);
-        auto error_callback = impl::get_error_callback(current_error_handler);
 
-        if (!impl::handle_first_arg_is_path(p_context)) {
-            error_callback(p_context, "Missing path.");
-            return parse_codes::missing_path;
+    // Compiled parameters.
+    inline compiled_parameters::compiled_parameters(const parameters& p_parameters, std::pmr::memory_resource* p_resource) :
+        m_name_arena(p_resource),
+        m_name_offsets(1, 0, p_resource),
+        m_name_hashes(p_resource),
+        m_name_kinds(p_resource),
+        m_name_items(p_resource),
+        m_lookup_slots(p_resource),
+        m_required_names(p_resource),
+        m_optional_names(p_resource),
+        m_command_names(p_resource),
+        m_required_setters(p_resource),
+        m_optional_setters(p_resource),
+        m_flag_setters(p_resource),
+        m_command_callbacks(p_resource),
+        m_source(std::make_shared<const parameters>(p_parameters))
+    {
+        const auto& source = *m_source;
+
+        auto name_count = size_t{ 0 };
+        auto name_length = size_t{ 0 };
+        auto count_names = [&](const std::vector<std::string>& p_names) {
+            name_count += p_names.size();
+            for (const auto& name : p_names) {
+                name_length += name.size();
+            }
+        };
+        for (const auto& option : source.required_options) {
+            count_names(option.names);
+        }
+        for (const auto& option : source.optional_options) {
+            count_names(option.names);
+        }
+        for (const auto& option : source.flag_options) {
+            count_names(option.names);
+        }
+        for (const auto& command : source.commands) {
+            count_names(command.names);
         }
 
-        // Help
-        if (current_help_handler != nullptr && current_help_handler->callback &&
-            p_context.argc > 0 && current_help_handler->has_name(p_context.argv[0]))
-        {
-            return current_help_handler->callback(p_context);
+        m_name_arena.reserve(name_length);
+        m_name_offsets.reserve(name_count + 1);
+        m_name_hashes.reserve(name_count);
+        m_name_kinds.reserve(name_count);
+        m_name_items.reserve(name_count);
+
+        m_required_names.reserve(source.required_options.size());
+        m_required_setters.reserve(source.required_options.size());
+        for (size_t i = 0; i < source.required_options.size(); ++i) {
+            const auto& option = source.required_options[i];
+            m_required_names.push_back(add_names(impl::name_kind::required, i, option.names));
+            m_required_setters.push_back(option.m_set_value_callback);
         }
 
-        // Required options.
-        for (auto& option : required_options) {
-            auto first_opt_name = !option.names.empty() ? option.names.front() : "opt";
+        m_optional_names.reserve(source.optional_options.size());
+        m_optional_setters.reserve(source.optional_options.size());
+        for (size_t i = 0; i < source.optional_options.size(); ++i) {
+            const auto& option = source.optional_options[i];
+            m_optional_names.push_back(add_names(impl::name_kind::optional, i, option.names));
+            m_optional_setters.push_back(option.m_set_value_callback);
+        }
 
-            if (p_context.argc <= 0) {
-                error_callback(p_context, "Missing option '" + first_opt_name + "'.");
-                return parse_codes::missing_option;
+        m_flag_setters.reserve(source.flag_options.size());
+        for (size_t i = 0; i < source.flag_options.size(); ++i) {
+            const auto& option = source.flag_options[i];
+            add_names(impl::name_kind::flag, i, option.names);
+            m_flag_setters.push_back(option.m_set_flag_callback);
+        }
+
+        m_command_names.reserve(source.commands.size());
+        m_command_callbacks.reserve(source.commands.size());
+        for (size_t i = 0; i < source.commands.size(); ++i) {
+            const auto& command = source.commands[i];
+            m_command_names.push_back(add_names(impl::name_kind::command, i, command.names));
+            if (command.child_parameters) {
+                m_command_callbacks.push_back([owner = &command](context& p_context) {
+                    return impl::parse_command_tree(p_context, *owner->child_parameters, owner);
+                });
+            }
+            else {
+                m_command_callbacks.push_back(command.callback);
             }
+        }
 
-            const auto opt_value = std::string_view{ p_context.argv[0] };
+        build_lookup();
+    }
 
-            if (!option.set_value(opt_value)) {
-                error_callback(p_context, "Invalid value '" + std::string{ opt_value } + "' of option '" + first_opt_name + "'.");
-                return parse_codes::invalid_option_value;
+    inline int compiled_parameters::parse(context& p_context) const {
+        if (const auto& source_parameters = source(); source_parameters.completion_handler.has_value()) {
+            if (const auto result = impl::parse_completion(p_context, source_parameters, source_parameters.completion_handler.value()); result.has_value()) {
+                return result.value();
             }
-
-            p_context.move_to_next_arg();
         }
+        p_context.environment_index.clear();
+        return impl::parse_schema(p_context, impl::compiled_parameters_schema{ *this });
+    }
 
-        do {
-            if (p_context.argc <= 0) {
-                if (!commands.empty()) {
-                    error_callback(p_context, "Missing command.");
-                    return parse_codes::missing_command;
-                }
-                else {
-                    return parse_codes::successful;
-                }
-            }
+    inline const parameters& compiled_parameters::source() const {
+        // Default constructed parameters have no source until one is compiled, and parse as empty parameters.
+        static const auto empty_source = parameters{};
+        return m_source ? *m_source : empty_source;
+    }
 
-            const auto opt_name = std::string_view{ p_context.argv[0] };
+    inline std::size_t compiled_parameters::name_count() const {
+        return m_name_kinds.size();
+    }
 
-            // Flag options.
-            auto find_flag = [&](std::string_view name) -> const option_flag_proxy* {
-                for (auto& flag_option : flag_options) {
-                    if (flag_option.has_name(name)) {
-                        return &flag_option;
-                    }
-                }
+    inline std::string_view compiled_parameters::name(std::size_t p_index) const {
+        const auto offset = m_name_offsets[p_index];
+        return std::string_view{ m_name_arena.data() + offset, m_name_offsets[p_index + 1] - offset };
+    }
 
-                return nullptr;
-            };
+    inline std::uint32_t compiled_parameters::add_name(impl::name_kind p_kind, std::size_t p_item, std::string_view p_name) {
+        const auto index = static_cast<std::uint32_t>(m_name_kinds.size());
+        m_name_arena.append(p_name);
+        m_name_offsets.push_back(static_cast<std::uint32_t>(m_name_arena.size()));
+        m_name_hashes.push_back(impl::hash_name(p_name));
+        m_name_kinds.push_back(p_kind);
+        m_name_items.push_back(static_cast<std::uint32_t>(p_item));
+        return index;
+    }
 
-            if (auto flag = find_flag(opt_name); flag != nullptr) {
-                if (!flag->set_flag()) {
-                    error_callback(p_context, "Failed to set flag of option '" + std::string{ opt_name } + "'.");
-                    return parse_codes::invalid_option_value;
-                }
+    inline std::uint32_t compiled_parameters::add_names(impl::name_kind p_kind, std::size_t p_item, const std::vector<std::string>& p_names) {
+        auto first = no_name;
+        for (const auto& name : p_names) {
+            const auto index = add_name(p_kind, p_item, name);
+            first = first == no_name ? index : first;
+        }
+        return first;
+    }
 
-                p_context.move_to_next_arg();
-                continue;
-            }
+    inline void compiled_parameters::build_lookup() {
+        auto slot_count = size_t{ 16 };
+        while (slot_count < m_name_kinds.size() * 2) {
+            slot_count *= 2;
+        }
+        m_lookup_slots.assign(slot_count, no_name);
 
-            // Optional options.
-            auto find_optional = [&](std::string_view name) -> const option_proxy* {
-                for (auto& optional_option : optional_options) {
-                    if (optional_option.has_name(name)) {
-                        return &optional_option;
-                    }
-                }
+        const auto mask = slot_count - 1;
+        for (std::uint32_t index = 0; index < m_name_kinds.size(); ++index) {
+            const auto kind = m_name_kinds[index];
+            if (kind == impl::name_kind::required || find(kind, name(index)) != impl::name_index::npos) {
+                continue; // First item with a given name wins, same as a linear scan.
+            }
 
-                return nullptr;
-            };
+            auto position = (m_name_hashes[index] ^ (static_cast<std::uint32_t>(kind) * std::uint32_t{ 0x9E3779B9u })) & mask;
+            while (m_lookup_slots[position] != no_name) {
+                position = (position + 1) & mask;
+            }
+            m_lookup_slots[position] = index;
+            m_short_names.add(kind, m_name_items[index], name(index));
+        }
+    }
 
-            if (auto optional = find_optional(opt_name); optional != nullptr) {
-                p_context.move_to_next_arg();
+    inline std::size_t compiled_parameters::find(impl::name_kind p_kind, std::string_view p_name) const {
+        if (m_lookup_slots.empty()) {
+            return impl::name_index::npos;
+        }
 
-                auto first_opt_name = !optional->names.empty() ? optional->names.front() : "opt";
+        const auto hash = impl::hash_name(p_name);
+        const auto mask = m_lookup_slots.size() - 1;
+        auto position = (hash ^ (static_cast<std::uint32_t>(p_kind) * std::uint32_t{ 0x9E3779B9u })) & mask;
 
-                if (p_context.argc <= 0) {
-                    error_callback(p_context, "Missing value of option '" + first_opt_name + "'.");
-                    return parse_codes::missing_option_value;
-                }
+        for (auto index = m_lookup_slots[position]; index != no_name; index = m_lookup_slots[position]) {
+            if (m_name_hashes[index] == hash && m_name_kinds[index] == p_kind && name(index) == p_name) {
+                return m_name_items[index];
+            }
+            position = (position + 1) & mask;
+        }
 
-                const auto opt_value = std::string_view{ p_context.argv[0] };
+        return impl::name_index::npos;
+    }
 
-                if (!optional->set_value(opt_value)) {
-                    error_callback(p_context, "Invalid value '" + std::string{ opt_value } + "' of option '" + first_opt_name + "'.");
-                    return parse_codes::invalid_option_value;
-                }
+    inline std::string_view compiled_parameters::first_name(std::uint32_t p_name) const {
+        return p_name != no_name ? name(p_name) : std::string_view{ "opt" };
+    }
 
-                p_context.move_to_next_arg();
-                continue;
-            }
-            else {
-                if (commands.empty()) {
-                    error_callback(p_context, "Unknown option '" + std::string{ opt_name } + "'.");
-                    return parse_codes::unknown_option;
-                }
-            }
 
-            // Command
-            auto find_command = [&](std::string_view name) -> const command* {
-                for (auto& command : commands) {
-                    if (command.has_name(name)) {
-                        return &command;
-                    }
-                }
+    // Parse result.
+    template<typename T>
+    inline bool parse_result::has(option_handle<T> p_handle) const {
+        const auto word = p_handle.index / 64;
+        return word < m_set_options.size() && (m_set_options[word] & (std::uint64_t{ 1 } << (p_handle.index % 64))) != 0;
+    }
 
-                return nullptr;
-            };
+    inline bool parse_result::has(command_handle p_handle) const {
+        return m_command == p_handle.index;
+    }
 
-            if (auto command = find_command(opt_name); command != nullptr) {
-                p_context.current_path.emplace_back(opt_name);
-                p_context.move_to_next_arg();
+    template<typename T>
+    inline T parse_result::get(option_handle<T> p_handle) const {
+        using type = impl::raw_option_type_t<T>;
 
-                return command->callback ? command->callback(p_context) : parse_codes::successful;
+        if constexpr (impl::is_template_instance_v<T, std::optional> == true) {
+            if (!has(p_handle)) {
+                return std::nullopt;
             }
+        }
 
-            // Help
-            if (current_help_handler != nullptr && current_help_handler->callback &&
-                current_help_handler->has_name(opt_name))
-            {
-                return current_help_handler->callback(p_context);
-            }
+        auto value = type{};
+        if (p_handle.offset + sizeof(type) <= m_storage.size() * sizeof(std::max_align_t)) {
+            std::memcpy(&value, slot(p_handle.offset), sizeof(type));
+        }
+        return value;
+    }
 
-            error_callback(p_context, "Unknown command '" + std::string{ opt_name } + "'.");
-            return parse_codes::unknown_command;
+    inline std::optional<command_handle> parse_result::command() const {
+        if (m_command == no_command) {
+            return std::nullopt;
+        }
+        return command_handle{ m_command };
+    }
 
-        } while (p_context.argc > 0);
+    inline void parse_result::reset(std::size_t p_storage_size, std::size_t p_option_count) {
+        const auto storage_words = (p_storage_size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        m_storage.assign(storage_words, std::max_align_t{});
+        m_set_options.assign((p_option_count + 63) / 64, std::uint64_t{ 0 });
+        m_command = no_command;
+        code = parse_codes::successful;
+    }
 
-        return parse_codes::successful;
+    inline void* parse_result::slot(std::size_t p_offset) {
+        return reinterpret_cast<unsigned char*>(m_storage.data()) + p_offset;
     }
 
-    template<typename T>
-    inline parameters& parameters::add_option(const option<T>& p_option) {
-        if constexpr (impl::is_template_instance_v<T, std::optional> == true) {
-            optional_options.emplace_back(p_option);
-        }
-        else {
-            required_options.emplace_back(p_option);
-        }
+    inline const void* parse_result::slot(std::size_t p_offset) const {
+        return reinterpret_cast<const unsigned char*>(m_storage.data()) + p_offset;
+    }
 
-        return *this;
+    inline void parse_result::set(std::size_t p_index) {
+        m_set_options[p_index / 64] |= std::uint64_t{ 1 } << (p_index % 64);
     }
+
+
+    // Detached parameters.
     template<typename T>
-    inline parameters& parameters::add_option(option<T>&& p_option) {
+    inline option_handle<T> detached_parameters::add_option(std::vector<std::string> p_names, std::string p_description) {
+        using type = impl::raw_option_type_t<T>;
+        static_assert(std::is_trivially_copyable_v<type> && std::is_trivially_destructible_v<type>,
+            "Detached option values must be trivially copyable, use std::string_view for strings.");
+
+        const auto handle = option_handle<T>{ m_option_count++, allocate_slot(sizeof(type), alignof(type)) };
+        auto option = impl::detached_option{
+            std::move(p_names),
+            std::move(p_description),
+            &impl::set_detached_value<type>,
+            handle.index,
+            handle.offset };
+
         if constexpr (impl::is_template_instance_v<T, std::optional> == true) {
-            optional_options.emplace_back(p_option);
+            m_optional_options.push_back(std::move(option));
+            m_lookup_index.add_item(impl::name_kind::optional, m_optional_options.back().names, *this);
         }
         else {
-            required_options.emplace_back(p_option);
+            m_required_options.push_back(std::move(option));
         }
-        return *this;
+
+        return handle;
     }
 
-    template<typename T>
-    inline parameters& parameters::add_option(const option_flag<T>& p_option_flag) {
-        flag_options.emplace_back(p_option_flag);
+    inline option_handle<bool> detached_parameters::add_flag(std::vector<std::string> p_names, std::string p_description) {
+        const auto handle = option_handle<bool>{ m_option_count++, allocate_slot(sizeof(bool), alignof(bool)) };
+        m_flag_options.push_back(impl::detached_option{
+            std::move(p_names),
+            std::move(p_description),
+            &impl::set_detached_value<bool>,
+            handle.index,
+            handle.offset });
+        m_lookup_index.add_item(impl::name_kind::flag, m_flag_options.back().names, *this);
+        return handle;
+    }
+
+    inline command_handle detached_parameters::add_command(std::vector<std::string> p_names, std::string p_description) {
+        const auto handle = command_handle{ m_commands.size() };
+        m_commands.push_back(impl::detached_command{ std::move(p_names), std::move(p_description) });
+        m_lookup_index.add_item(impl::name_kind::command, m_commands.back().names, *this);
+        return handle;
+    }
+
+    inline detached_parameters& detached_parameters::set_error(const error& p_error) {
+        error_handler = p_error;
         return *this;
     }
-    template<typename T>
-    inline parameters& parameters::add_option(option_flag<T>&& p_option_flag) {
-        flag_options.emplace_back(p_option_flag);
+    inline detached_parameters& detached_parameters::set_error(error&& p_error) {
+        error_handler = std::move(p_error);
         return *this;
     }
 
-    inline parameters& parameters::add_command(const command& p_command) {
-        commands.emplace_back(p_command);
+    inline detached_parameters& detached_parameters::set_help(const help& p_help) {
+        help_handler = p_help;
         return *this;
     }
-    inline parameters& parameters::add_command(command&& p_command) {
-        commands.emplace_back(std::move(p_command));
+    inline detached_parameters& detached_parameters::set_help(help&& p_help) {
+        help_handler = std::move(p_help);
         return *this;
     }
 
-    inline parameters& parameters::add_parameters(parameters&& p_parameters) {
-        required_options = std::move(p_parameters.required_options);
-        optional_options = std::move(p_parameters.optional_options);
-        flag_options = std::move(p_parameters.flag_options);
+    inline parse_result detached_parameters::parse(context& p_context) const {
+        auto result = parse_result{};
+        parse(p_context, result);
+        return result;
+    }
 
-        commands.insert(
-            commands.end(),
-            std::make_move_iterator(p_parameters.commands.begin()),
-            std::make_move_iterator(p_parameters.commands.end()));
-        p_parameters.commands.clear();
+    inline int detached_parameters::parse(context& p_context, parse_result& p_result) const {
+        p_result.reset(m_storage_size, m_option_count);
+        p_result.code = impl::parse_schema(p_context, impl::detached_parameters_schema{ *this, p_result });
+        return p_result.code;
+    }
 
-        if (!error_handler.has_value() && p_parameters.error_handler.has_value()) {
-            error_handler = std::move(p_parameters.error_handler);
+    inline void detached_parameters::parse_batch(
+        const arguments* p_arguments,
+        std::size_t p_count,
+        parse_result* p_results,
+        const context& p_context) const
+    {
+        // One scratch context is reused for the whole batch, keeping its handlers and path capacity.
+        auto scratch = p_context;
+        for (std::size_t i = 0; i < p_count; ++i) {
+            scratch.reset().set_arg(p_arguments[i].argc, p_arguments[i].argv);
+            parse(scratch, p_results[i]);
         }
+    }
 
-        if (!help_handler.has_value() && p_parameters.help_handler.has_value()) {
-            help_handler = std::move(p_parameters.help_handler);
+    inline void detached_parameters::parse_batch(
+        const std::vector<arguments>& p_arguments,
+        std::vector<parse_result>& p_results,
+        const context& p_context) const
+    {
+        p_results.resize(p_arguments.size());
+        parse_batch(p_arguments.data(), p_arguments.size(), p_results.data(), p_context);
+    }
+
+    inline const std::string* detached_parameters::indexed_name(impl::name_kind p_kind, std::size_t p_item, std::size_t p_alias) const {
+        auto get_name = [&](const auto& p_items) -> const std::string* {
+            if (p_item >= p_items.size() || p_alias >= p_items[p_item].names.size()) {
+                return nullptr;
+            }
+            return &p_items[p_item].names[p_alias];
+        };
+
+        switch (p_kind) {
+            case impl::name_kind::flag: return get_name(m_flag_options);
+            case impl::name_kind::optional: return get_name(m_optional_options);
+            case impl::name_kind::command: return get_name(m_commands);
+            case impl::name_kind::required: return get_name(m_required_options);
         }
+        return nullptr;
+    }
 
-        return *this;
+    inline std::size_t detached_parameters::allocate_slot(std::size_t p_size, std::size_t p_alignment) {
+        const auto offset = (m_storage_size + p_alignment - 1) / p_alignment * p_alignment;
+        m_storage_size = offset + p_size;
+        return offset;
     }
-    inline parameters& parameters::add_parameters(const parameters& p_parameters) {
-        required_options = p_parameters.required_options;
-        optional_options = p_parameters.optional_options;
-        flag_options = p_parameters.flag_options;
 
-        commands.insert(
-            commands.end(),
-            p_parameters.commands.begin(),
-            p_parameters.commands.end());
 
-        if (!error_handler.has_value() && p_parameters.error_handler.has_value()) {
-            error_handler = p_parameters.error_handler;
-        }
+    // Static parameters.
+    template<typename... TElements>
+    inline int static_parameters<TElements...>::parse(context& p_context) const {
+        return impl::parse_schema(p_context, impl::static_parameters_schema<TElements...>{ *this });
+    }
 
-        if (!help_handler.has_value() && p_parameters.help_handler.has_value()) {
-            help_handler = p_parameters.help_handler;
-        }
+    template<typename... TElements>
+    inline parameters static_parameters<TElements...>::to_parameters() const {
+        auto params = parameters{};
 
-        return *this;
+        std::apply([&](const auto&... p_element) {
+            auto add_element = [&](const auto& p_current) {
+                using element_type = std::decay_t<decltype(p_current)>;
+
+                if constexpr (impl::is_static_command<element_type>::value) {
+                    auto callback = command_callback{};
+                    if constexpr (std::is_pointer_v<std::decay_t<decltype(p_current.callback)>>) {
+                        if (p_current.callback) {
+                            callback = p_current.callback;
+                        }
+                    }
+                    else {
+                        callback = p_current.callback;
+                    }
+
+                    params.add_command(command{
+                        impl::split_static_names(p_current.names),
+                        std::string{ p_current.description },
+                        std::move(callback) });
+                }
+                else if constexpr (impl::is_static_flag<element_type>::value) {
+                    params.add_option(option_flag<std::remove_reference_t<decltype(p_current.value)>>{
+                        p_current.value,
+                        impl::split_static_names(p_current.names),
+                        std::string{ p_current.description } });
+                }
+                else {
+                    params.add_option(option<std::remove_reference_t<decltype(p_current.value)>>{
+                        p_current.value,
+                        impl::split_static_names(p_current.names),
+                        std::string{ p_current.description } });
+                }
+            };
+
+            (add_element(p_element), ...);
+        }, elements);
+
+        params.error_handler = error_handler;
+        params.help_handler = help_handler;
+        return params;
     }
 
-    inline parameters& parameters::set_error(const error& p_error) {
+    template<typename... TElements>
+    inline static_parameters<TElements...>& static_parameters<TElements...>::set_error(const error& p_error) {
         error_handler = p_error;
         return *this;
     }
-    inline parameters& parameters::set_error(error&& p_error) {
+    template<typename... TElements>
+    inline static_parameters<TElements...>& static_parameters<TElements...>::set_error(error&& p_error) {
         error_handler = std::move(p_error);
         return *this;
     }
 
-    inline parameters& parameters::set_help(const help& p_help) {
+    template<typename... TElements>
+    inline static_parameters<TElements...>& static_parameters<TElements...>::set_help(const help& p_help) {
         help_handler = p_help;
         return *this;
     }
-    inline parameters& parameters::set_help(help&& p_help) {
+    template<typename... TElements>
+    inline static_parameters<TElements...>& static_parameters<TElements...>::set_help(help&& p_help) {
         help_handler = std::move(p_help);
         return *this;
     }
@@ -1730,6 +6800,78 @@ namespace cppli {
         return std::move(lhs);
     }
 
+    inline parameters operator | (const parameters& lhs, const rest_arguments& rhs) {
+        auto params = parameters{ lhs };
+        params.set_rest_arguments(rhs);
+        return params;
+    }
+    inline parameters operator | (const parameters& lhs, rest_arguments&& rhs) {
+        auto params = parameters{ lhs };
+        params.set_rest_arguments(std::move(rhs));
+        return params;
+    }
+    inline parameters operator | (parameters&& lhs, const rest_arguments& rhs) {
+        lhs.set_rest_arguments(rhs);
+        return std::move(lhs);
+    }
+    inline parameters operator | (parameters&& lhs, rest_arguments&& rhs) {
+        lhs.set_rest_arguments(std::move(rhs));
+        return std::move(lhs);
+    }
+
+
+
+    // Static parameters operators.
+    template<typename TLhs, typename TRhs>
+    inline impl::enable_if_static_element_t<TLhs, impl::enable_if_static_element_t<TRhs,
+        static_parameters<std::decay_t<TLhs>, std::decay_t<TRhs>>>> operator | (TLhs&& lhs, TRhs&& rhs)
+    {
+        return { std::tuple<std::decay_t<TLhs>, std::decay_t<TRhs>>{ std::forward<TLhs>(lhs), std::forward<TRhs>(rhs) } };
+    }
+
+    template<typename... TElements, typename TRhs>
+    inline impl::enable_if_static_element_t<TRhs, static_parameters<TElements..., std::decay_t<TRhs>>>
+        operator | (const static_parameters<TElements...>& lhs, TRhs&& rhs)
+    {
+        return {
+            std::tuple_cat(lhs.elements, std::tuple<std::decay_t<TRhs>>{ std::forward<TRhs>(rhs) }),
+            lhs.error_handler,
+            lhs.help_handler };
+    }
+    template<typename... TElements, typename TRhs>
+    inline impl::enable_if_static_element_t<TRhs, static_parameters<TElements..., std::decay_t<TRhs>>>
+        operator | (static_parameters<TElements...>&& lhs, TRhs&& rhs)
+    {
+        return {
+            std::tuple_cat(std::move(lhs.elements), std::tuple<std::decay_t<TRhs>>{ std::forward<TRhs>(rhs) }),
+            std::move(lhs.error_handler),
+            std::move(lhs.help_handler) };
+    }
+
+    template<typename... TElements>
+    inline static_parameters<TElements...> operator | (const static_parameters<TElements...>& lhs, const error& rhs) {
+        auto params = static_parameters<TElements...>{ lhs };
+        params.set_error(rhs);
+        return params;
+    }
+    template<typename... TElements>
+    inline static_parameters<TElements...> operator | (static_parameters<TElements...>&& lhs, const error& rhs) {
+        lhs.set_error(rhs);
+        return std::move(lhs);
+    }
+
+    template<typename... TElements>
+    inline static_parameters<TElements...> operator | (const static_parameters<TElements...>& lhs, const help& rhs) {
+        auto params = static_parameters<TElements...>{ lhs };
+        params.set_help(rhs);
+        return params;
+    }
+    template<typename... TElements>
+    inline static_parameters<TElements...> operator | (static_parameters<TElements...>&& lhs, const help& rhs) {
+        lhs.set_help(rhs);
+        return std::move(lhs);
+    }
+
 }
 
 #endif
\ No newline at end of file
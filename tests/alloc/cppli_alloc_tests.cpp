@@ -0,0 +1,370 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "gtest/gtest.h"
+#include "cppli/cppli.hpp"
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions, to verify that successful parses never allocate.
+namespace test {
+
+    std::atomic<bool> count_allocations = false;
+    std::atomic<size_t> allocation_count = 0;
+
+    void* allocate(std::size_t p_size) {
+        if (count_allocations) {
+            ++allocation_count;
+        }
+        if (auto* result = std::malloc(p_size > 0 ? p_size : 1)) {
+            return result;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void* allocate_aligned(std::size_t p_size, std::align_val_t p_alignment) {
+        if (count_allocations) {
+            ++allocation_count;
+        }
+        const auto alignment = static_cast<std::size_t>(p_alignment);
+        const auto size = (std::max(p_size, std::size_t{ 1 }) + alignment - 1) / alignment * alignment;
+        if (auto* result = std::aligned_alloc(alignment, size)) {
+            return result;
+        }
+        throw std::bad_alloc{};
+    }
+
+    template<typename TFunction>
+    size_t count_allocations_of(TFunction&& p_function) {
+        allocation_count = 0;
+        count_allocations = true;
+        p_function();
+        count_allocations = false;
+        return allocation_count;
+    }
+
+}
+
+void* operator new(std::size_t p_size) { return test::allocate(p_size); }
+void* operator new[](std::size_t p_size) { return test::allocate(p_size); }
+void* operator new(std::size_t p_size, std::align_val_t p_alignment) { return test::allocate_aligned(p_size, p_alignment); }
+void* operator new[](std::size_t p_size, std::align_val_t p_alignment) { return test::allocate_aligned(p_size, p_alignment); }
+void operator delete(void* p_pointer) noexcept { std::free(p_pointer); }
+void operator delete[](void* p_pointer) noexcept { std::free(p_pointer); }
+void operator delete(void* p_pointer, std::size_t) noexcept { std::free(p_pointer); }
+void operator delete[](void* p_pointer, std::size_t) noexcept { std::free(p_pointer); }
+void operator delete(void* p_pointer, std::align_val_t) noexcept { std::free(p_pointer); }
+void operator delete[](void* p_pointer, std::align_val_t) noexcept { std::free(p_pointer); }
+void operator delete(void* p_pointer, std::size_t, std::align_val_t) noexcept { std::free(p_pointer); }
+void operator delete[](void* p_pointer, std::size_t, std::align_val_t) noexcept { std::free(p_pointer); }
+
+namespace cli = cppli;
+
+namespace {
+
+    auto args = std::array{ "path/to/program", "input.txt", "8", "TRUE", "--ratio", "0.5", "-v", "build", "--jobs", "4" };
+
+    cli::context create_context() {
+        return cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    }
+
+}
+
+TEST(allocation, parameters)
+{
+    auto input = std::string_view{};
+    auto count = 0;
+    auto enabled = false;
+    auto ratio = std::optional<double>{};
+    auto verbose = false;
+    auto jobs = std::optional<int>{};
+
+    const auto build_params
+        = cli::parameters{}
+        | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }
+        | cli::default_error{};
+
+    const auto params
+        = cli::option<std::string_view>{ input, { "input" } }
+        | cli::option<int>{ count, { "count" } }
+        | cli::option<bool>{ enabled, { "enabled" } }
+        | cli::option<std::optional<double>>{ ratio, { "-r", "--ratio" } }
+        | cli::option_flag<bool>{ verbose, { "-v" } }
+        | cli::command{ { "build" }, "", [&build_params](cli::context& p_context) { return build_params.parse(p_context); } }
+        | cli::command{ { "clean" } }
+        | cli::default_error{};
+
+    auto context = create_context();
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() { code = params.parse(context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(input, "input.txt");
+    EXPECT_EQ(count, 8);
+    EXPECT_TRUE(enabled);
+    EXPECT_EQ(ratio, std::optional<double>{ 0.5 });
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ(jobs, std::optional<int>{ 4 });
+
+    // Formatting the default error message allocates, which verifies the counter itself.
+    auto error_args = std::array{ "path/to/program", "input.txt", "not_a_number" };
+    auto error_context = cli::context{}.set_arg(static_cast<int>(error_args.size()), const_cast<char**>(error_args.data()));
+    std::cerr.setstate(std::ios_base::failbit);
+    EXPECT_GT(test::count_allocations_of([&]() { code = params.parse(error_context); }), size_t{ 0 });
+    std::cerr.clear();
+    EXPECT_EQ(code, cli::parse_codes::invalid_option_value);
+
+    const auto compiled = params.compile();
+    auto compiled_context = create_context();
+    EXPECT_EQ(test::count_allocations_of([&]() { code = compiled.parse(compiled_context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+
+    // Nothing is compiled into default constructed parameters yet.
+    EXPECT_EQ(test::count_allocations_of([]() { cli::compiled_parameters{}; }), size_t{ 0 });
+
+    // Clustered flags and attached values are sliced from the arguments.
+    auto getopt_args = std::array{ "path/to/program", "input.txt", "8", "TRUE", "-vr0.25", "build", "--jobs=2" };
+    auto getopt_context = cli::context{}.set_arg(static_cast<int>(getopt_args.size()), const_cast<char**>(getopt_args.data()));
+    EXPECT_EQ(test::count_allocations_of([&]() { code = params.parse(getopt_context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(ratio, std::optional<double>{ 0.25 });
+    EXPECT_EQ(jobs, std::optional<int>{ 2 });
+
+    auto files = cli::argument_span{};
+    const auto rest_params
+        = cli::parameters{}
+        | cli::option_flag<bool>{ verbose, { "-v" } }
+        | cli::rest_arguments{ files };
+    auto rest_args = std::array{ "path/to/program", "-v", "--", "a", "-b", "c" };
+    auto rest_context = cli::context{}.set_arg(static_cast<int>(rest_args.size()), const_cast<char**>(rest_args.data()));
+    EXPECT_EQ(test::count_allocations_of([&]() { code = rest_params.parse(rest_context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(files.size(), size_t{ 3 });
+}
+
+TEST(allocation, static_parameters)
+{
+    auto input = std::string_view{};
+    auto count = 0;
+    auto enabled = false;
+    auto ratio = std::optional<double>{};
+    auto verbose = false;
+    auto jobs = std::optional<int>{};
+
+    const auto params
+        = cli::static_option<std::string_view>{ input, "input" }
+        | cli::static_option<int>{ count, "count" }
+        | cli::static_option<bool>{ enabled, "enabled" }
+        | cli::static_option<std::optional<double>>{ ratio, "-r|--ratio" }
+        | cli::static_option_flag<bool>{ verbose, "-v" }
+        | cli::static_command{ "build", "", [&jobs](cli::context& p_context) {
+            const auto build_params = cli::static_option<std::optional<int>>{ jobs, "-j|--jobs" } | cli::static_command{ "none" };
+            return p_context.argc > 0 ? build_params.parse(p_context) : 0;
+        } };
+
+    auto context = create_context();
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() { code = params.parse(context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(count, 8);
+    EXPECT_TRUE(enabled);
+    EXPECT_TRUE(verbose);
+}
+
+TEST(allocation, detached_parameters)
+{
+    auto params = cli::detached_parameters{};
+    const auto input = params.add_option<std::string_view>({ "input" });
+    const auto count = params.add_option<int>({ "count" });
+    const auto enabled = params.add_option<bool>({ "enabled" });
+    const auto ratio = params.add_option<std::optional<double>>({ "-r", "--ratio" });
+    const auto verbose = params.add_flag({ "-v" });
+    const auto build = params.add_command({ "build" });
+
+    auto result = cli::parse_result{};
+    auto warmup_context = create_context();
+    ASSERT_EQ(params.parse(warmup_context, result), cli::parse_codes::successful);
+
+    auto context = create_context();
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() { code = params.parse(context, result); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(result.get(input), "input.txt");
+    EXPECT_EQ(result.get(count), 8);
+    EXPECT_TRUE(result.get(enabled));
+    EXPECT_EQ(result.get(ratio), std::optional<double>{ 0.5 });
+    EXPECT_TRUE(result.get(verbose));
+    EXPECT_TRUE(result.has(build));
+}
+
+TEST(allocation, numeric_formats)
+{
+    auto buffer = cli::byte_size{};
+    auto timeout = std::chrono::milliseconds{};
+    auto mask = std::uint32_t{};
+
+    const auto params
+        = cli::option<cli::byte_size>{ buffer, { "buffer" } }
+        | cli::option<std::chrono::milliseconds>{ timeout, { "timeout" } }
+        | cli::option<std::uint32_t>{ mask, { "mask" } };
+
+    auto numeric_args = std::array{ "path/to/program", "1.5GiB", "1.5s", "0xff00" };
+    auto context = cli::context{}.set_arg(static_cast<int>(numeric_args.size()), const_cast<char**>(numeric_args.data()));
+
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() { code = params.parse(context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(buffer.bytes, std::uint64_t{ 3 } * 512 * 1024 * 1024);
+    EXPECT_EQ(timeout, std::chrono::milliseconds{ 1500 });
+    EXPECT_EQ(mask, std::uint32_t{ 0xff00 });
+}
+
+TEST(allocation, memory_resource)
+{
+    auto input = std::string_view{};
+    auto count = 0;
+    auto enabled = false;
+    auto ratio = std::optional<double>{};
+    auto verbose = false;
+
+    const auto params
+        = cli::option<std::string_view>{ input, { "input" } }
+        | cli::option<int>{ count, { "count" } }
+        | cli::option<bool>{ enabled, { "enabled" } }
+        | cli::option<std::optional<double>>{ ratio, { "-r", "--ratio" } }
+        | cli::option_flag<bool>{ verbose, { "-v" } }
+        | cli::command{ { "build" } }
+        | cli::error{ [](cli::context&, const cli::parse_error&) {} };
+
+    // Deep paths and the error message live in the arena, which has no upstream to fall back on.
+    auto buffer = std::array<std::byte, 1024>{};
+    auto arena = std::pmr::monotonic_buffer_resource{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+    auto context = cli::context{};
+    context.set_memory_resource(&arena);
+    EXPECT_EQ(context.memory_resource(), &arena);
+
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() {
+        context.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        code = params.parse(context);
+    }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(context.current_path.size(), size_t{ 2 });
+
+    EXPECT_EQ(test::count_allocations_of([&]() {
+        context.reset().set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        code = params.parse(context);
+    }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+
+    auto error = cli::parse_error{ cli::parse_codes::unknown_option, "--unknown" };
+    auto matches = false;
+    EXPECT_EQ(test::count_allocations_of([&]() { matches = error.message(&arena) == "Unknown option '--unknown'."; }), size_t{ 0 });
+    EXPECT_TRUE(matches);
+}
+
+TEST(allocation, environment)
+{
+    auto jobs = std::optional<int>{};
+    auto ratio = std::optional<double>{};
+    auto verbose = false;
+
+    const auto params
+        = cli::parameters{}
+        | cli::option<std::optional<int>>{ jobs, { "--jobs" } }.set_environment("APP_JOBS")
+        | cli::option<std::optional<double>>{ ratio, { "--ratio" } }.set_environment("APP_RATIO")
+        | cli::option_flag<bool>{ verbose, { "-v" } }.set_environment("APP_VERBOSE");
+
+    auto environment = std::array<char*, 4>{
+        const_cast<char*>("APP_JOBS=8"),
+        const_cast<char*>("APP_RATIO=0.25"),
+        const_cast<char*>("APP_VERBOSE=1"),
+        nullptr };
+    auto environment_args = std::array{ "path/to/program", "--ratio", "0.5" };
+
+    // The environment index and the marks of options given as arguments live in the arena.
+    auto buffer = std::array<std::byte, 1024>{};
+    auto arena = std::pmr::monotonic_buffer_resource{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+    auto context = cli::context{}.set_environment(environment.data());
+    context.set_memory_resource(&arena);
+
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() {
+        context.set_arg(static_cast<int>(environment_args.size()), const_cast<char**>(environment_args.data()));
+        code = params.parse(context);
+    }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    EXPECT_EQ(jobs, std::optional<int>{ 8 });
+    EXPECT_EQ(ratio, std::optional<double>{ 0.5 });
+    EXPECT_TRUE(verbose);
+}
+
+TEST(allocation, completion)
+{
+    auto verbose = false;
+    auto build = cli::command{ { "build" } };
+    build.set_child_parameters(cli::parameters{} | cli::option_flag<bool>{ verbose, { "-v", "--verbose" } });
+    const auto params = cli::parameters{}
+        | std::move(build)
+        | cli::command{ { "bundle" } }
+        | cli::parameters{}.set_completion(cli::completion{});
+
+    // Candidates are written without building word or output buffers, the invalid fd only drops them.
+    auto completion_args = std::array{ "path/to/program", "__complete", "build", "--" };
+    auto context = cli::context{}.set_arg(static_cast<int>(completion_args.size()), const_cast<char**>(completion_args.data()));
+    context.output_fd = -1;
+    auto code = -1;
+    EXPECT_EQ(test::count_allocations_of([&]() { code = params.parse(context); }), size_t{ 0 });
+    EXPECT_EQ(code, cli::parse_codes::successful_completion);
+}
+
+TEST(allocation, repeated_vector_option)
+{
+    auto includes = std::vector<std::string_view>{};
+    const auto params
+        = cli::parameters{}
+        | cli::option<std::vector<std::string_view>>{ includes, { "-I" } };
+
+    auto storage = std::vector<std::string>{};
+    for (size_t i = 0; i < 4096; ++i) {
+        storage.push_back("dir" + std::to_string(i));
+    }
+    auto repeated_args = std::vector<char*>{ const_cast<char*>("path/to/program") };
+    for (auto& dir : storage) {
+        repeated_args.push_back(const_cast<char*>("-I"));
+        repeated_args.push_back(dir.data());
+    }
+
+    // Values are views into argv, and the vector grows geometrically instead of once per occurrence.
+    auto context = cli::context{}.set_arg(static_cast<int>(repeated_args.size()), repeated_args.data());
+    auto code = -1;
+    EXPECT_LE(test::count_allocations_of([&]() { code = params.parse(context); }), size_t{ 16 });
+    EXPECT_EQ(code, cli::parse_codes::successful);
+    ASSERT_EQ(includes.size(), storage.size());
+    for (size_t i = 0; i < storage.size(); ++i) {
+        EXPECT_EQ(includes[i].data(), storage[i].data());
+    }
+}
@@ -592,6 +592,1518 @@ TEST(parameters, multiple_options)
     }
 }
 
+TEST(parameters, lookup_index)
+{
+    auto flags = std::array<bool, 100>{};
+    auto values = std::array<std::optional<int>, 100>{};
+    auto triggered_command = size_t{ 0 };
+
+    auto params = cli::parameters{};
+    for (size_t i = 0; i < 100; i++) {
+        const auto id = std::to_string(i);
+        params.add_option(cli::option_flag<bool>{ flags[i], { "-f" + id, "--flag" + id } });
+        params.add_option(cli::option<std::optional<int>>{ values[i], { "-v" + id, "--value" + id } });
+        params.add_command(cli::command{ { "cmd" + id, "alias" + id }, "", [&triggered_command, i](auto&) {
+            triggered_command = i;
+            return 0;
+        } });
+    }
+
+    ASSERT_NE(params.find_flag("--flag42"), nullptr);
+    EXPECT_EQ(params.find_flag("--flag42"), &params.flag_options[42]);
+    EXPECT_EQ(params.find_flag("-f99"), &params.flag_options[99]);
+    EXPECT_EQ(params.find_flag("-v1"), nullptr);
+    EXPECT_EQ(params.find_optional("--value7"), &params.optional_options[7]);
+    EXPECT_EQ(params.find_optional("--flag7"), nullptr);
+    EXPECT_EQ(params.find_command("alias64"), &params.commands[64]);
+    EXPECT_EQ(params.find_command("cmd100"), nullptr);
+    EXPECT_EQ(params.find_command(""), nullptr);
+
+    // OK
+    {
+        auto args = std::array{ "path/to/program", "-f3", "--value5", "55", "--flag98", "alias77" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+
+        EXPECT_EQ(params.parse(context), cli::parse_codes::successful);
+        EXPECT_TRUE(flags[3]);
+        EXPECT_TRUE(flags[98]);
+        EXPECT_FALSE(flags[4]);
+        ASSERT_TRUE(values[5].has_value());
+        EXPECT_EQ(values[5].value(), 55);
+        EXPECT_EQ(triggered_command, size_t{ 77 });
+    }
+
+    // Copies keep a valid index.
+    {
+        const auto params_copy = params;
+        EXPECT_EQ(params_copy.find_command("cmd12"), &params_copy.commands[12]);
+    }
+
+    // First item with a duplicated name wins, as with a linear scan.
+    {
+        bool first = false;
+        bool second = false;
+        auto duplicate_params
+            = cli::option_flag<bool>{ first, { "-d" } }
+            | cli::option_flag<bool>{ second, { "-x", "-d" } };
+
+        EXPECT_EQ(duplicate_params.find_flag("-d"), &duplicate_params.flag_options[0]);
+        EXPECT_EQ(duplicate_params.find_flag("-x"), &duplicate_params.flag_options[1]);
+    }
+
+    // Items added without add_* are found by falling back to a linear scan.
+    {
+        auto modified_params = params;
+        modified_params.commands.push_back(cli::command{ { "direct" } });
+
+        EXPECT_EQ(modified_params.find_command("direct"), &modified_params.commands.back());
+        EXPECT_EQ(modified_params.find_command("cmd3"), &modified_params.commands[3]);
+
+        modified_params.rebuild_index();
+        EXPECT_EQ(modified_params.find_command("direct"), &modified_params.commands.back());
+
+        // Renamed in place, then rebuilt.
+        modified_params.commands[3].names.front() = "renamed";
+        modified_params.rebuild_index();
+        EXPECT_EQ(modified_params.find_command("renamed"), &modified_params.commands[3]);
+        EXPECT_EQ(modified_params.find_command("cmd3"), nullptr);
+    }
+}
+
+TEST(parse_value, numeric_formats)
+{
+    auto int_value = 0;
+    EXPECT_TRUE(cli::impl::parse_value(int_value, "0x1F"));
+    EXPECT_EQ(int_value, 31);
+    EXPECT_TRUE(cli::impl::parse_value(int_value, "-0b101"));
+    EXPECT_EQ(int_value, -5);
+    EXPECT_TRUE(cli::impl::parse_value(int_value, "0o17"));
+    EXPECT_EQ(int_value, 15);
+    EXPECT_TRUE(cli::impl::parse_value(int_value, "-2147483648"));
+    EXPECT_EQ(int_value, std::numeric_limits<int>::min());
+    EXPECT_FALSE(cli::impl::parse_value(int_value, "2147483648"));
+    EXPECT_FALSE(cli::impl::parse_value(int_value, "12abc"));
+    EXPECT_FALSE(cli::impl::parse_value(int_value, "0x"));
+
+    auto unsigned_value = std::uint8_t{};
+    EXPECT_TRUE(cli::impl::parse_value(unsigned_value, "0xff"));
+    EXPECT_EQ(unsigned_value, 255);
+    EXPECT_FALSE(cli::impl::parse_value(unsigned_value, "0x100"));
+    EXPECT_FALSE(cli::impl::parse_value(unsigned_value, "-1"));
+
+    auto size = cli::byte_size{};
+    EXPECT_TRUE(cli::impl::parse_value(size, "4MiB"));
+    EXPECT_EQ(size.bytes, std::uint64_t{ 4 } * 1024 * 1024);
+    EXPECT_TRUE(cli::impl::parse_value(size, "4M"));
+    EXPECT_EQ(size.bytes, std::uint64_t{ 4000000 });
+    EXPECT_TRUE(cli::impl::parse_value(size, "1.5KiB"));
+    EXPECT_EQ(size.bytes, std::uint64_t{ 1536 });
+    EXPECT_TRUE(cli::impl::parse_value(size, "2kB"));
+    EXPECT_EQ(size.bytes, std::uint64_t{ 2000 });
+    EXPECT_TRUE(cli::impl::parse_value(size, "512"));
+    EXPECT_EQ(size.bytes, std::uint64_t{ 512 });
+    EXPECT_FALSE(cli::impl::parse_value(size, "16777216TiB"));
+    EXPECT_FALSE(cli::impl::parse_value(size, "4iB"));
+    EXPECT_FALSE(cli::impl::parse_value(size, "4X"));
+
+    auto timeout = std::chrono::milliseconds{};
+    EXPECT_TRUE(cli::impl::parse_value(timeout, "1.5s"));
+    EXPECT_EQ(timeout, std::chrono::milliseconds{ 1500 });
+    EXPECT_TRUE(cli::impl::parse_value(timeout, "2m"));
+    EXPECT_EQ(timeout, std::chrono::minutes{ 2 });
+    EXPECT_TRUE(cli::impl::parse_value(timeout, "250"));
+    EXPECT_EQ(timeout, std::chrono::milliseconds{ 250 });
+    EXPECT_TRUE(cli::impl::parse_value(timeout, "1500us"));
+    EXPECT_EQ(timeout, std::chrono::milliseconds{ 2 });
+    EXPECT_FALSE(cli::impl::parse_value(timeout, "1.5 s"));
+    EXPECT_FALSE(cli::impl::parse_value(timeout, "s"));
+
+    auto small_duration = std::chrono::duration<std::int16_t>{};
+    EXPECT_FALSE(cli::impl::parse_value(small_duration, "10h"));
+
+    auto optional_timeout = std::optional<std::chrono::seconds>{};
+    auto params = cli::parameters{} | cli::option<std::optional<std::chrono::seconds>>{ optional_timeout, { "--timeout" } };
+    auto args = std::array{ "path/to/program", "--timeout", "1h" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    EXPECT_EQ(params.parse(context), cli::parse_codes::successful);
+    EXPECT_EQ(optional_timeout, std::optional<std::chrono::seconds>{ 3600 });
+
+    auto overflow_args = std::array{ "path/to/program", "--timeout", "99999999999999999999h" };
+    auto overflow_context = cli::context{}.set_arg(static_cast<int>(overflow_args.size()), const_cast<char**>(overflow_args.data()));
+    EXPECT_EQ(params.parse(overflow_context), cli::parse_codes::invalid_option_value);
+}
+
+TEST(parameters, add_parameters_appends)
+{
+    auto first = 0;
+    auto second = 0;
+    auto first_flag = false;
+    auto second_flag = false;
+    auto first_optional = std::optional<int>{};
+    auto second_optional = std::optional<int>{};
+
+    auto params
+        = cli::parameters{}
+        | cli::option<int>{ first, { "first" } }
+        | cli::option_flag<bool>{ first_flag, { "--first-flag" } }
+        | cli::option<std::optional<int>>{ first_optional, { "--first-optional" } };
+
+    params.add_parameters(
+        cli::parameters{}
+        | cli::option<int>{ second, { "second" } }
+        | cli::option_flag<bool>{ second_flag, { "--second-flag" } }
+        | cli::option<std::optional<int>>{ second_optional, { "--second-optional" } }
+        | cli::command{ { "run" } });
+
+    EXPECT_EQ(params.required_options.size(), size_t{ 2 });
+    EXPECT_EQ(params.optional_options.size(), size_t{ 2 });
+    EXPECT_EQ(params.flag_options.size(), size_t{ 2 });
+    EXPECT_NE(params.find_flag("--first-flag"), nullptr);
+    EXPECT_NE(params.find_flag("--second-flag"), nullptr);
+    EXPECT_NE(params.find_optional("--second-optional"), nullptr);
+    EXPECT_NE(params.find_command("run"), nullptr);
+
+    auto args = std::array{ "path/to/program", "1", "2", "--first-flag", "--second-optional", "3", "run" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    ASSERT_EQ(params.parse(context), cli::parse_codes::successful);
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 2);
+    EXPECT_TRUE(first_flag);
+    EXPECT_FALSE(second_flag);
+    EXPECT_EQ(second_optional, std::optional<int>{ 3 });
+}
+
+TEST(parameters_builder, build)
+{
+    constexpr size_t command_count = 1000;
+    auto flags = std::array<bool, 2>{};
+    auto value = std::optional<int>{};
+    auto called = std::vector<size_t>{};
+
+    auto builder = cli::parameters_builder{};
+    builder.reserve(0, 1, flags.size(), command_count);
+    builder.add_option(cli::option<std::optional<int>>{ value, { "-v", "--value" } });
+    builder.add_option(cli::option_flag<bool>{ flags[0], { "-a" } });
+    builder.add_option(cli::option_flag<bool>{ flags[1], { "-b" } });
+    for (size_t i = 0; i < command_count; i++) {
+        builder.add_command(cli::command{ { "command" + std::to_string(i), "alias" + std::to_string(i) }, "", [&called, i](cli::context&) {
+            called.push_back(i);
+            return 0;
+        } });
+    }
+    builder.set_error(cli::default_error{});
+
+    const auto params = builder.build();
+    EXPECT_EQ(params.commands.size(), command_count);
+    EXPECT_TRUE(params.error_handler.has_value());
+    EXPECT_NE(params.find_command("alias999"), nullptr);
+
+    auto args = std::array{ "path/to/program", "-b", "--value", "5", "alias567" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    ASSERT_EQ(params.parse(context), cli::parse_codes::successful);
+    EXPECT_FALSE(flags[0]);
+    EXPECT_TRUE(flags[1]);
+    EXPECT_EQ(value, std::optional<int>{ 5 });
+    EXPECT_EQ(called, std::vector<size_t>{ 567 });
+}
+
+TEST(parameters, child_parameters)
+{
+    auto name = std::string{};
+    auto force = false;
+    auto url = std::string{};
+    auto calls = std::vector<std::string>{};
+
+    auto remote_add = cli::command{ { "add" }, "Add remote.", [&calls](cli::context&) { calls.push_back("add"); return 0; } };
+    remote_add.set_child_parameters(cli::option<std::string>{ name, { "name" } } | cli::option<std::string>{ url, { "url" } });
+
+    auto remote = cli::command{ { "remote" }, "Manage remotes." };
+    remote.set_child_parameters(
+        cli::parameters{}
+        | std::move(remote_add)
+        | cli::command{ { "list" }, "List remotes.", [&calls](cli::context&) { calls.push_back("list"); return 0; } });
+
+    auto init = cli::command{ { "init" }, "Init.", [&calls](cli::context&) { calls.push_back("init"); return 0; } };
+    init.set_child_parameters(cli::parameters{} | cli::option_flag<bool>{ force, { "-f", "--force" } });
+
+    const auto params = cli::parameters{} | std::move(remote) | std::move(init) | cli::default_help{};
+
+    auto parse = [](const auto& p_parameters, auto p_args) {
+        auto context = cli::context{}.set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()));
+        const auto code = p_parameters.parse(context);
+        return std::make_pair(code, std::vector<std::string_view>(context.current_path.begin(), context.current_path.end()));
+    };
+
+    const auto [add_code, add_path] = parse(params, std::array{ "path/to/program", "remote", "add", "origin", "http://host" });
+    EXPECT_EQ(add_code, cli::parse_codes::successful);
+    EXPECT_EQ(name, "origin");
+    EXPECT_EQ(url, "http://host");
+    EXPECT_EQ(add_path, (std::vector<std::string_view>{ "program", "remote", "add" }));
+
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "remote", "list" }).first, cli::parse_codes::successful);
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "init", "--force" }).first, cli::parse_codes::successful);
+    EXPECT_TRUE(force);
+    EXPECT_EQ(calls, (std::vector<std::string>{ "add", "list", "init" }));
+
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "remote", "add", "origin" }).first, cli::parse_codes::missing_option);
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "remote", "unknown" }).first, cli::parse_codes::unknown_command);
+
+    const auto compiled = params.compile();
+    calls.clear();
+    EXPECT_EQ(parse(compiled, std::array{ "path/to/program", "remote", "add", "upstream", "http://other" }).first, cli::parse_codes::successful);
+    EXPECT_EQ(name, "upstream");
+    EXPECT_EQ(calls, (std::vector<std::string>{ "add" }));
+
+    // Help of a subcommand, without running any callback.
+    calls.clear();
+    auto output = test::output_pipe{};
+    auto help_args = std::array{ "path/to/program", "remote", "--help" };
+    auto help_context = cli::context{}.set_arg(static_cast<int>(help_args.size()), const_cast<char**>(help_args.data())) | cli::default_help{};
+    help_context.output_fd = output.fd();
+    EXPECT_EQ(params.parse(help_context), cli::parse_codes::successful_help);
+    EXPECT_EQ(output.read(),
+        "Usage: remote [command] [command-options]\n\n"
+        "Commands:\n"
+        "  -h|--help      Show command line help.\n"
+        "  add            Add remote.\n"
+        "  list           List remotes.\n");
+    EXPECT_TRUE(calls.empty());
+
+    const auto* remote_command = params.find_command("remote");
+    ASSERT_NE(remote_command, nullptr);
+    ASSERT_TRUE(remote_command->child_parameters);
+    EXPECT_NE(remote_command->child_parameters->find_command("add"), nullptr);
+}
+
+TEST(parameters, vector_options)
+{
+    auto includes = std::vector<std::string_view>{};
+    auto ids = std::vector<int>{};
+    auto verbose = false;
+
+    auto params
+        = cli::option<std::vector<std::string_view>>{ includes, { "-I", "--include" } }
+        | cli::option<std::vector<int>>{ ids, { "--ids" } }
+        | cli::option_flag<bool>{ verbose, { "-v" } };
+
+    EXPECT_EQ(params.required_options.size(), size_t{ 0 });
+    EXPECT_EQ(params.optional_options.size(), size_t{ 2 });
+
+    {
+        auto args = std::array{ "path/to/program", "-I", "a", "--ids", "1,2,0x3", "--include", "b,c", "-v", "--ids", "4" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        ASSERT_EQ(params.parse(context), cli::parse_codes::successful);
+
+        EXPECT_EQ(includes, (std::vector<std::string_view>{ "a", "b", "c" }));
+        EXPECT_EQ(ids, (std::vector<int>{ 1, 2, 3, 4 }));
+        EXPECT_TRUE(verbose);
+
+        // String views point into argv.
+        EXPECT_EQ(includes[0].data(), args[2]);
+        EXPECT_EQ(includes[1].data(), args[6]);
+        EXPECT_EQ(includes[2].data(), args[6] + 2);
+    }
+    {
+        ids.clear();
+        auto args = std::array{ "path/to/program", "--ids", "1", "--ids", "2,x,3" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        ASSERT_EQ(params.parse(context), cli::parse_codes::invalid_option_value);
+        EXPECT_EQ(ids, (std::vector<int>{ 1 }));
+    }
+    {
+        auto static_ids = std::vector<std::uint64_t>{};
+        const auto static_params = cli::static_option<std::vector<std::uint64_t>>{ static_ids, "--ids" } | cli::static_option_flag<bool>{ verbose, "-v" };
+        auto args = std::array{ "path/to/program", "--ids", "5,6", "--ids", "7" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        ASSERT_EQ(static_params.parse(context), cli::parse_codes::successful);
+        EXPECT_EQ(static_ids, (std::vector<std::uint64_t>{ 5, 6, 7 }));
+    }
+}
+
+TEST(parameters, environment)
+{
+    auto input = std::string{};
+    auto jobs = std::optional<int>{ 1 };
+    auto level = std::optional<std::string>{};
+    auto verbose = false;
+    auto quiet = false;
+    auto build_jobs = std::optional<int>{};
+
+    auto build = cli::command{ { "build" } };
+    build.set_child_parameters(cli::parameters{} | cli::option<std::optional<int>>{ build_jobs, { "--build-jobs" } }.set_environment("APP_BUILD_JOBS"));
+
+    const auto params = cli::parameters{}
+        | cli::option<std::string>{ input, { "input" } }.set_environment("APP_INPUT")
+        | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }.set_environment("APP_JOBS")
+        | cli::option<std::optional<std::string>>{ level, { "--level" } }.set_environment("APP_UNSET")
+        | cli::option_flag<bool>{ verbose, { "-v", "--verbose" } }.set_environment("APP_VERBOSE")
+        | cli::option_flag<bool>{ quiet, { "-q", "--quiet" } }.set_environment("APP_QUIET")
+        | cli::parameters{};
+
+    auto environment = std::array<const char*, 8>{
+        "PATH=/usr/bin", "APP_INPUT=from_env", "APP_JOBS=8", "APP_VERBOSE=true", "APP_QUIET=0", "APP_JOBS=9", "APP_BUILD_JOBS=3", nullptr };
+    auto parse = [&](const auto& p_parameters, auto p_args) {
+        auto context = cli::context{}
+            .set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()))
+            .set_environment(const_cast<char**>(environment.data()));
+        return p_parameters.parse(context);
+    };
+
+    // Precedence: arguments, then environment, then the initial value of the bound variable.
+    ASSERT_EQ(parse(params, std::array{ "path/to/program" }), cli::parse_codes::successful);
+    EXPECT_EQ(input, "from_env");
+    EXPECT_EQ(jobs, std::optional<int>{ 8 });
+    EXPECT_FALSE(level.has_value());
+    EXPECT_TRUE(verbose);
+    EXPECT_FALSE(quiet);
+
+    verbose = false;
+    ASSERT_EQ(parse(params, std::array{ "path/to/program", "from_args", "--jobs", "2" }), cli::parse_codes::successful);
+    EXPECT_EQ(input, "from_args");
+    EXPECT_EQ(jobs, std::optional<int>{ 2 });
+    EXPECT_TRUE(verbose);
+
+    const auto compiled = params.compile();
+    jobs.reset();
+    ASSERT_EQ(parse(compiled, std::array{ "path/to/program", "from_args" }), cli::parse_codes::successful);
+    EXPECT_EQ(jobs, std::optional<int>{ 8 });
+
+    // Child parameters read the environment before their command runs.
+    const auto command_params = cli::parameters{} | std::move(build);
+    ASSERT_EQ(parse(command_params, std::array{ "path/to/program", "build" }), cli::parse_codes::successful);
+    EXPECT_EQ(build_jobs, std::optional<int>{ 3 });
+
+    // Required options read the environment without any other option bound to it.
+    auto count = 0;
+    const auto required_params = cli::parameters{} | cli::option<int>{ count, { "count" } }.set_environment("APP_COUNT");
+    environment[6] = "APP_COUNT=7";
+    ASSERT_EQ(parse(required_params, std::array{ "path/to/program" }), cli::parse_codes::successful);
+    EXPECT_EQ(count, 7);
+    ASSERT_EQ(parse(required_params.compile(), std::array{ "path/to/program", "4" }), cli::parse_codes::successful);
+    EXPECT_EQ(count, 4);
+
+    environment[2] = "APP_JOBS=many";
+    EXPECT_EQ(parse(params, std::array{ "path/to/program" }), cli::parse_codes::invalid_option_value);
+    environment[1] = "OTHER=1";
+    EXPECT_EQ(parse(params, std::array{ "path/to/program" }), cli::parse_codes::missing_option);
+}
+
+TEST(parameters, abbreviations)
+{
+    auto template_name = std::optional<std::string>{};
+    auto verbose = false;
+    auto calls = std::vector<std::string>{};
+
+    auto make_params = [&](bool p_allow) {
+        return cli::parameters{}
+            | cli::option<std::optional<std::string>>{ template_name, { "-t", "--template", "--templates" } }
+            | cli::option_flag<bool>{ verbose, { "--verbose" } }
+            | cli::command{ { "build" }, "", [&calls](cli::context&) { calls.push_back("build"); return 0; } }
+            | cli::command{ { "bundle" }, "", [&calls](cli::context&) { calls.push_back("bundle"); return 0; } }
+            | cli::command{ { "test", "tests" }, "", [&calls](cli::context&) { calls.push_back("test"); return 0; } }
+            | cli::parameters{}.set_abbreviations(p_allow);
+    };
+    const auto params = make_params(true);
+
+    auto last_error = cli::parse_error{};
+    auto last_message = std::string{};
+    auto candidates = std::vector<std::string>{};
+    auto parse = [&](const auto& p_parameters, auto p_args) {
+        auto context = cli::context{}.set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()))
+            | cli::error{ [&](cli::context&, const cli::parse_error& p_error) {
+                last_error = p_error;
+                last_message = p_error.message();
+                auto names = std::array<std::string_view, 8>{};
+                const auto count = p_error.suggestions(names.data(), names.size());
+                candidates.assign(names.begin(), names.begin() + static_cast<std::ptrdiff_t>(count));
+            } };
+        return p_parameters.parse(context);
+    };
+
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "--temp", "release", "--verb", "bui" }), cli::parse_codes::successful);
+    EXPECT_EQ(template_name, std::optional<std::string>{ "release" });
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "te" }), cli::parse_codes::successful);
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "test" }), cli::parse_codes::successful);
+    EXPECT_EQ(calls, (std::vector<std::string>{ "build", "test", "test" }));
+
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "bu" }), cli::parse_codes::ambiguous_name);
+    EXPECT_EQ(last_error.code, cli::parse_codes::ambiguous_name);
+    EXPECT_EQ(last_error.arg_index, 1);
+    EXPECT_EQ(candidates, (std::vector<std::string>{ "build", "bundle" }));
+    EXPECT_EQ(last_message, "Ambiguous name 'bu'. Did you mean 'build' or 'bundle'?");
+
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "--t=debug", "te" }), cli::parse_codes::successful);
+    EXPECT_EQ(template_name, std::optional<std::string>{ "debug" });
+
+    // "-" and "--" are never prefixes of the dashed names.
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "--" }), cli::parse_codes::unknown_command);
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "-" }), cli::parse_codes::unknown_command);
+
+    auto files = cli::argument_span{};
+    const auto rest_params = cli::parameters{}
+        | cli::option_flag<bool>{ verbose, { "--verbose" } }
+        | cli::option<std::optional<std::string>>{ template_name, { "--template" } }
+        | cli::rest_arguments{ files }
+        | cli::parameters{}.set_abbreviations();
+    EXPECT_EQ(parse(rest_params, std::array{ "path/to/program", "-" }), cli::parse_codes::successful);
+    ASSERT_EQ(files.size(), size_t{ 1 });
+    EXPECT_EQ(files[0], "-");
+
+    verbose = false;
+    const auto single_params = cli::parameters{}
+        | cli::option_flag<bool>{ verbose, { "--verbose" } }
+        | cli::rest_arguments{ files }
+        | cli::parameters{}.set_abbreviations();
+    EXPECT_EQ(parse(single_params, std::array{ "path/to/program", "-", "--" }), cli::parse_codes::successful);
+    EXPECT_FALSE(verbose);
+    EXPECT_EQ(files.size(), size_t{ 2 });
+
+    EXPECT_EQ(parse(params, std::array{ "path/to/program", "x" }), cli::parse_codes::unknown_command);
+
+    const auto compiled = params.compile();
+    calls.clear();
+    EXPECT_EQ(parse(compiled, std::array{ "path/to/program", "bun" }), cli::parse_codes::successful);
+    EXPECT_EQ(calls, (std::vector<std::string>{ "bundle" }));
+
+    // Abbreviations are opt-in.
+    EXPECT_EQ(parse(make_params(false), std::array{ "path/to/program", "bui" }), cli::parse_codes::unknown_command);
+}
+
+TEST(parameters, getopt_forms)
+{
+    auto debug = false;
+    auto verbose = false;
+    auto output = std::optional<std::string>{};
+    auto jobs = std::optional<int>{};
+    auto built = false;
+
+    const auto params = cli::parameters{}
+        | cli::option_flag<bool>{ debug, { "-d", "--debug" } }
+        | cli::option_flag<bool>{ verbose, { "-v" } }
+        | cli::option<std::optional<std::string>>{ output, { "-o", "--output" } }
+        | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }
+        | cli::command{ { "build" }, "", [&built](cli::context&) { built = true; return 0; } };
+
+    auto last_error = cli::parse_error{};
+    auto parse = [&](const auto& p_parameters, auto p_args) {
+        debug = false;
+        verbose = false;
+        output.reset();
+        jobs.reset();
+        built = false;
+        auto context = cli::context{}.set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()))
+            | cli::error{ [&](cli::context&, const cli::parse_error& p_error) { last_error = p_error; } };
+        return p_parameters.parse(context);
+    };
+
+    const auto compiled = params.compile();
+    auto check = [&](const auto& p_parameters) {
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "-dv", "--output=out.txt", "--jobs=4", "build" }), cli::parse_codes::successful);
+        EXPECT_TRUE(debug);
+        EXPECT_TRUE(verbose);
+        EXPECT_EQ(output, std::optional<std::string>{ "out.txt" });
+        EXPECT_EQ(jobs, std::optional<int>{ 4 });
+        EXPECT_TRUE(built);
+
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "-j8", "-vdofile=a", "build" }), cli::parse_codes::successful);
+        EXPECT_EQ(jobs, std::optional<int>{ 8 });
+        EXPECT_TRUE(debug);
+        EXPECT_TRUE(verbose);
+        EXPECT_EQ(output, std::optional<std::string>{ "file=a" });
+
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "-vo", "out.txt", "--output=", "build" }), cli::parse_codes::successful);
+        EXPECT_TRUE(verbose);
+        EXPECT_EQ(output, std::optional<std::string>{ "" });
+
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "-vx", "build" }), cli::parse_codes::unknown_option);
+        EXPECT_EQ(last_error.token, "-vx");
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "-vo" }), cli::parse_codes::missing_option_value);
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "--jobs=x", "build" }), cli::parse_codes::invalid_option_value);
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "--debug=1", "build" }), cli::parse_codes::invalid_option_value);
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "--unknown=1", "build" }), cli::parse_codes::unknown_command);
+        EXPECT_EQ(parse(p_parameters, std::array{ "path/to/program", "-xv", "build" }), cli::parse_codes::unknown_command);
+    };
+    check(params);
+    check(compiled);
+
+    auto static_params
+        = cli::static_option_flag<bool>{ debug, "-d" }
+        | cli::static_option_flag<bool>{ verbose, "-v" }
+        | cli::static_option<std::optional<int>>{ jobs, "-j|--jobs" };
+    EXPECT_EQ(parse(static_params, std::array{ "path/to/program", "-dvj3" }), cli::parse_codes::successful);
+    EXPECT_TRUE(debug);
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ(jobs, std::optional<int>{ 3 });
+
+    auto detached = cli::detached_parameters{};
+    const auto detached_verbose = detached.add_flag({ "-v" });
+    const auto detached_count = detached.add_option<std::optional<int>>({ "-c", "--count" });
+    auto args = std::array{ "path/to/program", "-vc5" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    const auto result = detached.parse(context);
+    ASSERT_EQ(result.code, cli::parse_codes::successful);
+    EXPECT_TRUE(result.get(detached_verbose));
+    EXPECT_EQ(result.get(detached_count), std::optional<int>{ 5 });
+}
+
+TEST(parameters, rest_arguments)
+{
+    auto jobs = std::optional<int>{};
+    auto verbose = false;
+    auto files = cli::argument_span{};
+    auto built = false;
+
+    const auto params = cli::parameters{}
+        | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }
+        | cli::option_flag<bool>{ verbose, { "-v" } }
+        | cli::rest_arguments{ files, "files" };
+
+    auto parse = [&](const auto& p_parameters, auto& p_args) {
+        jobs.reset();
+        verbose = false;
+        files = {};
+        built = false;
+        auto context = cli::context{}.set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()))
+            | cli::error{ [](cli::context&, const cli::parse_error&) {} };
+        return p_parameters.parse(context);
+    };
+
+    auto check = [&](const auto& p_parameters) {
+        auto args = std::array{ "path/to/program", "--jobs", "8", "--", "file1", "-v", "--jobs", "--" };
+        EXPECT_EQ(parse(p_parameters, args), cli::parse_codes::successful);
+        EXPECT_EQ(jobs, std::optional<int>{ 8 });
+        EXPECT_FALSE(verbose);
+        ASSERT_EQ(files.size(), size_t{ 4 });
+        EXPECT_EQ(files.argv(), const_cast<char**>(args.data()) + 4);
+        EXPECT_EQ((std::vector<std::string_view>(files.begin(), files.end())), (std::vector<std::string_view>{ "file1", "-v", "--jobs", "--" }));
+
+        // Rest arguments also start at the first positional argument, which ends the options.
+        auto positional_args = std::array{ "path/to/program", "-v", "file1", "-", "-j" };
+        EXPECT_EQ(parse(p_parameters, positional_args), cli::parse_codes::successful);
+        EXPECT_TRUE(verbose);
+        EXPECT_EQ((std::vector<std::string_view>(files.begin(), files.end())), (std::vector<std::string_view>{ "file1", "-", "-j" }));
+
+        auto empty_args = std::array{ "path/to/program", "-v", "--" };
+        EXPECT_EQ(parse(p_parameters, empty_args), cli::parse_codes::successful);
+        EXPECT_TRUE(verbose);
+        EXPECT_TRUE(files.empty());
+
+        auto unknown_args = std::array{ "path/to/program", "-x", "file1" };
+        EXPECT_EQ(parse(p_parameters, unknown_args), cli::parse_codes::unknown_option);
+    };
+    check(params);
+    check(params.compile());
+
+    // Tokens are viewed in place as well.
+    const auto tokens = std::vector<std::string_view>{ "path/to/program", "-j2", "a b", "c" };
+    auto token_context = cli::context{}.set_tokens(tokens);
+    EXPECT_EQ(params.parse(token_context), cli::parse_codes::successful);
+    EXPECT_EQ(files.tokens(), tokens.data() + 2);
+    EXPECT_EQ(files[0], "a b");
+    EXPECT_EQ(files[1], "c");
+
+    // Commands are matched before positional arguments.
+    const auto command_params = cli::parameters{}
+        | cli::command{ { "build" }, "", [&built](cli::context&) { built = true; return 0; } }
+        | cli::rest_arguments{ files };
+    auto command_args = std::array{ "path/to/program", "build" };
+    EXPECT_EQ(parse(command_params, command_args), cli::parse_codes::successful);
+    EXPECT_TRUE(built);
+    auto file_args = std::array{ "path/to/program", "input", "build" };
+    EXPECT_EQ(parse(command_params, file_args), cli::parse_codes::successful);
+    EXPECT_FALSE(built);
+    EXPECT_EQ(files.size(), size_t{ 2 });
+
+    // Rest arguments after "--" stand in for the command as well, but an empty rest does not.
+    auto terminated_args = std::array{ "path/to/program", "--", "a", "b" };
+    EXPECT_EQ(parse(command_params, terminated_args), cli::parse_codes::successful);
+    EXPECT_FALSE(built);
+    EXPECT_EQ(files.size(), size_t{ 2 });
+    auto terminated_empty_args = std::array{ "path/to/program", "--" };
+    EXPECT_EQ(parse(command_params, terminated_empty_args), cli::parse_codes::missing_command);
+    EXPECT_EQ(parse(command_params.compile(), terminated_empty_args), cli::parse_codes::missing_command);
+    auto missing_args = std::array{ "path/to/program" };
+    EXPECT_EQ(parse(command_params, missing_args), cli::parse_codes::missing_command);
+
+    EXPECT_EQ(cli::default_help::default_string(cli::context{}, params).find("Usage:  [options] [--] <files>..."), size_t{ 0 });
+}
+
+TEST(parameters, completion)
+{
+    auto verbose = false;
+    auto jobs = std::optional<int>{};
+    auto force = false;
+    auto calls = 0;
+
+    auto push = cli::command{ { "push" }, "Push.", [&calls](cli::context&) { ++calls; return 0; } };
+    push.set_child_parameters(cli::parameters{} | cli::option_flag<bool>{ force, { "-f", "--force" } });
+
+    auto remote = cli::command{ { "remote" }, "Manage remotes." };
+    remote.set_child_parameters(
+        cli::parameters{}
+        | cli::command{ { "add" }, "Add remote.", [&calls](cli::context&) { ++calls; return 0; } }
+        | cli::command{ { "list" }, "List remotes.", [&calls](cli::context&) { ++calls; return 0; } });
+
+    const auto params = cli::parameters{}
+        | cli::option_flag<bool>{ verbose, { "-v", "--verbose" } }
+        | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }
+        | std::move(remote)
+        | std::move(push)
+        | cli::command{ { "pull" }, "Pull." }
+        | cli::default_help{}
+        | cli::parameters{}.set_completion(cli::completion{});
+
+    auto complete = [&params](std::vector<std::string_view> p_words) {
+        auto candidates = std::vector<std::string_view>{};
+        const auto count = cli::completion::candidates(params, p_words.data(), p_words.size(), candidates);
+        EXPECT_EQ(count, candidates.size());
+        return candidates;
+    };
+
+    EXPECT_EQ(complete({ "" }), (std::vector<std::string_view>{ "remote", "push", "pull" }));
+    EXPECT_EQ(complete({ "pu" }), (std::vector<std::string_view>{ "push", "pull" }));
+    EXPECT_EQ(complete({ "--" }), (std::vector<std::string_view>{ "--jobs", "--verbose", "--help" }));
+    EXPECT_EQ(complete({ "-v", "-j", "4", "re" }), (std::vector<std::string_view>{ "remote" }));
+    EXPECT_EQ(complete({ "remote", "" }), (std::vector<std::string_view>{ "add", "list" }));
+    EXPECT_EQ(complete({ "push", "" }), (std::vector<std::string_view>{ "-f", "--force", "-h", "--help" }));
+    EXPECT_TRUE(complete({ "-j", "" }).empty());
+    EXPECT_TRUE(complete({ "pull", "" }).empty());
+    EXPECT_TRUE(complete({ "unknown", "" }).empty());
+
+    // Runtime mode walks the schema, prints the candidates and runs no callback.
+    auto output = test::output_pipe{};
+    auto args = std::array{ "path/to/program", "__complete", "remote", "" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    context.output_fd = output.fd();
+    EXPECT_EQ(params.parse(context), cli::parse_codes::successful_completion);
+    EXPECT_EQ(output.read(), "add\nlist\n");
+
+    auto help_args = std::array{ "path/to/program", "__complete", "-" };
+    auto help_context = cli::context{}.set_arg(static_cast<int>(help_args.size()), const_cast<char**>(help_args.data()));
+    auto help_output = test::output_pipe{};
+    help_context.output_fd = help_output.fd();
+    EXPECT_EQ(params.parse(help_context), cli::parse_codes::successful_completion);
+    EXPECT_EQ(help_output.read(), "-j\n--jobs\n-v\n--verbose\n-h\n--help\n");
+    EXPECT_EQ(calls, 0);
+
+    // Compiled parameters complete from their source.
+    const auto compiled = params.compile();
+    auto compiled_output = test::output_pipe{};
+    auto compiled_context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    compiled_context.output_fd = compiled_output.fd();
+    EXPECT_EQ(compiled.parse(compiled_context), cli::parse_codes::successful_completion);
+    EXPECT_EQ(compiled_output.read(), "add\nlist\n");
+    EXPECT_EQ(calls, 0);
+
+    const auto bash = cli::completion{}.script(cli::completion_shell::bash, "my-tool");
+    EXPECT_NE(bash.find("complete -o default -F _my_tool_complete my-tool"), std::string::npos);
+    EXPECT_NE(bash.find("__complete"), std::string::npos);
+    EXPECT_NE(cli::completion{}.script(cli::completion_shell::zsh, "my-tool").find("#compdef my-tool"), std::string::npos);
+    EXPECT_NE(cli::completion{}.set_name("__c").script(cli::completion_shell::fish, "my-tool").find("$words[1] __c $words[2..-1] \"$cur\""), std::string::npos);
+}
+
+TEST(path_stack, push)
+{
+    auto path = cli::path_stack{ "program" };
+    ASSERT_EQ(path.size(), size_t{ 1 });
+    EXPECT_EQ(path.capacity(), cli::path_stack::inline_capacity);
+
+    // Names past the inline capacity spill to the memory resource.
+    auto names = std::vector<std::string>{};
+    for (size_t i = 0; i < 20; ++i) {
+        names.push_back("command" + std::to_string(i));
+    }
+    for (const auto& name : names) {
+        path.emplace_back(name);
+    }
+    ASSERT_EQ(path.size(), size_t{ 21 });
+    EXPECT_GE(path.capacity(), size_t{ 21 });
+    EXPECT_EQ(path.front(), "program");
+    EXPECT_EQ(path.back(), "command19");
+    EXPECT_EQ(path[10], "command9");
+
+    const auto copy = path;
+    auto moved = std::move(path);
+    EXPECT_TRUE(path.empty());
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), moved.begin(), moved.end()));
+
+    moved.pop_back();
+    EXPECT_EQ(moved.back(), "command18");
+    const auto capacity = moved.capacity();
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(moved.capacity(), capacity);
+
+    auto arena = std::pmr::monotonic_buffer_resource{};
+    auto arena_path = cli::path_stack{ &arena };
+    arena_path.reserve(32);
+    EXPECT_EQ(arena_path.resource(), &arena);
+    EXPECT_EQ(arena_path.capacity(), size_t{ 32 });
+}
+
+TEST(tokenizer, tokenize)
+{
+    auto tokenizer = cli::tokenizer{};
+
+    const auto line = std::string_view{ "  build --name 'hello world' \"a \\\"b\\\" c\" plain\\ space '' x\\\n  y " };
+    ASSERT_TRUE(tokenizer.tokenize(line));
+    const auto& tokens = tokenizer.tokens();
+    ASSERT_EQ(tokens.size(), size_t{ 8 });
+    EXPECT_EQ(tokens[0], "build");
+    EXPECT_EQ(tokens[1], "--name");
+    EXPECT_EQ(tokens[2], "hello world");
+    EXPECT_EQ(tokens[3], "a \"b\" c");
+    EXPECT_EQ(tokens[4], "plain space");
+    EXPECT_EQ(tokens[5], "");
+    EXPECT_EQ(tokens[6], "x");
+    EXPECT_EQ(tokens[7], "y");
+
+    // Unquoted tokens point into the original line.
+    EXPECT_EQ(tokens[0].data(), line.data() + 2);
+
+    EXPECT_FALSE(tokenizer.tokenize("build 'unterminated"));
+    EXPECT_FALSE(tokenizer.tokenize("build \"unterminated"));
+    EXPECT_FALSE(tokenizer.tokenize("build \\"));
+
+    ASSERT_TRUE(tokenizer.tokenize("build \"my file.txt\" -j 8"));
+
+    auto name = std::string{};
+    auto jobs = std::optional<int>{};
+    auto params
+        = cli::option<std::optional<int>>{ jobs, { "-j" } }
+        | cli::command{ { "build" }, "", [&](cli::context& p_context) {
+            return (cli::option<std::string>{ name, { "name" } } | cli::option<std::optional<int>>{ jobs, { "-j" } }).parse(p_context);
+        } };
+
+    auto context = cli::context{}.set_tokens(tokenizer.tokens());
+    context.first_arg_is_path = false;
+    EXPECT_EQ(params.parse(context), cli::parse_codes::successful);
+    EXPECT_EQ(name, "my file.txt");
+    EXPECT_EQ(jobs, std::optional<int>{ 8 });
+    EXPECT_EQ(context.argc, 0);
+    EXPECT_EQ(context.arg_index, 4);
+}
+
+TEST(response_file_expander, expand)
+{
+    const auto directory = testing::TempDir();
+    const auto outer_path = directory + "cppli_outer.rsp";
+    const auto inner_path = directory + "cppli_inner.rsp";
+    const auto loop_path = directory + "cppli_loop.rsp";
+    std::ofstream{ outer_path } << "-i first\n@" << inner_path << "\n-i 'last file'\n";
+    std::ofstream{ inner_path } << "-v\n-i second\n";
+    std::ofstream{ loop_path } << "@" << loop_path;
+
+    const auto outer_argument = "@" + outer_path;
+    auto args = std::array{ "path/to/program", "build", outer_argument.c_str(), "-d" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+
+    auto expander = cli::response_file_expander{};
+    ASSERT_TRUE(expander.expand(context));
+
+    const auto expected = std::vector<std::string_view>{
+        "path/to/program", "build", "-i", "first", "-v", "-i", "second", "-i", "last file", "-d" };
+    EXPECT_EQ(expander.tokens(), expected);
+
+    auto inputs = std::vector<std::string>{};
+    auto verbose = false;
+    auto debug = false;
+    auto input = std::optional<std::string>{};
+    auto params = cli::parameters{} | cli::command{ { "build" }, "", [&](cli::context& p_context) {
+        const auto build_params
+            = cli::option<std::optional<std::string>>{ input, { "-i" } }
+            | cli::option_flag<bool>{ verbose, { "-v" } }
+            | cli::option_flag<bool>{ debug, { "-d" } };
+        return build_params.parse(p_context);
+    } };
+
+    auto expanded_context = cli::context{}.set_tokens(expander.tokens());
+    EXPECT_EQ(params.parse(expanded_context), cli::parse_codes::successful);
+    EXPECT_EQ(input, std::optional<std::string>{ "last file" });
+    EXPECT_TRUE(verbose);
+    EXPECT_TRUE(debug);
+
+    const auto loop_argument = "@" + loop_path;
+    auto loop_args = std::array{ "path/to/program", loop_argument.c_str() };
+    auto loop_context = cli::context{}.set_arg(static_cast<int>(loop_args.size()), const_cast<char**>(loop_args.data()));
+    EXPECT_FALSE(expander.expand(loop_context));
+
+    auto missing_args = std::array{ "path/to/program", "@/non/existing/file.rsp" };
+    auto missing_context = cli::context{}.set_arg(static_cast<int>(missing_args.size()), const_cast<char**>(missing_args.data()));
+    EXPECT_FALSE(expander.expand(missing_context));
+
+    std::remove(outer_path.c_str());
+    std::remove(inner_path.c_str());
+    std::remove(loop_path.c_str());
+}
+
+TEST(config_file, parse)
+{
+    const auto path = testing::TempDir() + "cppli_config.ini";
+    std::ofstream{ path } <<
+        "# Service settings.\n"
+        "input = data.bin\n"
+        "jobs = 4\n"
+        "level = \"very # verbose\"\n"
+        "verbose = true  # inline comment\n"
+        "includes = a,b\n"
+        "\n"
+        "[remote.add]\n"
+        "url = 'http://host'\n"
+        "force = 1\n";
+
+    auto config = cli::config_file{};
+    ASSERT_TRUE(config.load(path));
+    ASSERT_EQ(config.entries().size(), std::size_t{ 7 });
+    EXPECT_EQ(config.entries()[2].value, "very # verbose");
+    EXPECT_EQ(config.entries()[3].value, "true");
+    EXPECT_EQ(config.entries()[5].section, "remote.add");
+    EXPECT_EQ(config.entries()[5].line, std::size_t{ 9 });
+
+    auto input = std::string{};
+    auto jobs = std::optional<int>{};
+    auto level = std::optional<std::string>{};
+    auto verbose = false;
+    auto includes = std::vector<std::string>{};
+    auto url = std::optional<std::string>{};
+    auto force = false;
+    auto calls = 0;
+
+    auto add = cli::command{ { "add", "a" }, "", [&calls](cli::context&) { ++calls; return 0; } };
+    add.set_child_parameters(cli::parameters{}
+        | cli::option<std::optional<std::string>>{ url, { "--url" } }
+        | cli::option_flag<bool>{ force, { "-f", "--force" } });
+    auto remote = cli::command{ { "remote", "rmt" } };
+    remote.set_child_parameters(cli::parameters{} | std::move(add));
+
+    const auto params = cli::parameters{}
+        | cli::option<std::string>{ input, { "input" } }
+        | cli::option<std::optional<int>>{ jobs, { "-j", "--jobs" } }.set_environment("APP_JOBS")
+        | cli::option<std::optional<std::string>>{ level, { "--level" } }
+        | cli::option_flag<bool>{ verbose, { "-v", "--verbose" } }
+        | cli::option<std::vector<std::string>>{ includes, { "--includes" } }
+        | std::move(remote);
+
+    auto environment = std::array<const char*, 2>{ "APP_JOBS=6", nullptr };
+    auto parse = [&](auto p_args, const cli::config_file& p_config) {
+        auto context = cli::context{}
+            .set_arg(static_cast<int>(p_args.size()), const_cast<char**>(p_args.data()))
+            .set_environment(const_cast<char**>(environment.data()))
+            .set_config(p_config);
+        return params.parse(context);
+    };
+
+    // Precedence: arguments, then environment, then config file.
+    ASSERT_EQ(parse(std::array{ "path/to/program", "from_args", "--includes", "c", "remote", "add" }, config), cli::parse_codes::successful);
+    EXPECT_EQ(input, "from_args");
+    EXPECT_EQ(jobs, std::optional<int>{ 6 });
+    EXPECT_EQ(level, std::optional<std::string>{ "very # verbose" });
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ(includes, (std::vector<std::string>{ "c" }));
+    EXPECT_EQ(url, std::optional<std::string>{ "http://host" });
+    EXPECT_TRUE(force);
+    EXPECT_EQ(calls, 1);
+
+    // Sections are matched by the first name of each command, also when an alias is typed.
+    url.reset();
+    force = false;
+    ASSERT_EQ(parse(std::array{ "path/to/program", "from_args", "rmt", "a" }, config), cli::parse_codes::successful);
+    EXPECT_EQ(url, std::optional<std::string>{ "http://host" });
+    EXPECT_TRUE(force);
+    EXPECT_EQ(calls, 2);
+
+    auto unknown = cli::config_file{};
+    ASSERT_TRUE(unknown.load_string("input = x\njbos = 1\n"));
+    EXPECT_EQ(parse(std::array{ "path/to/program", "x", "remote", "add" }, unknown), cli::parse_codes::unknown_option);
+
+    auto invalid = cli::config_file{};
+    ASSERT_TRUE(invalid.load_string("input = x\n[remote.add]\nforce = maybe\n"));
+    EXPECT_EQ(parse(std::array{ "path/to/program", "x", "remote", "add" }, invalid), cli::parse_codes::invalid_option_value);
+
+    // Required options are taken from the config file once the arguments run out.
+    const auto required_params = cli::parameters{} | cli::option<std::string>{ input, { "input" } } | cli::parameters{};
+    auto required_config = cli::config_file{};
+    ASSERT_TRUE(required_config.load_string("input = data.bin\n"));
+    auto required_args = std::array{ "path/to/program" };
+    auto required_context = cli::context{}
+        .set_arg(static_cast<int>(required_args.size()), const_cast<char**>(required_args.data()))
+        .set_config(required_config);
+    ASSERT_EQ(required_params.parse(required_context), cli::parse_codes::successful);
+    EXPECT_EQ(input, "data.bin");
+
+    auto malformed = cli::config_file{};
+    EXPECT_FALSE(malformed.load_string("a = 1\n[section\n"));
+    EXPECT_EQ(malformed.error_line(), std::size_t{ 2 });
+    EXPECT_FALSE(malformed.load_string("a = 1\nb\n"));
+    EXPECT_EQ(malformed.error_line(), std::size_t{ 2 });
+    EXPECT_FALSE(malformed.load(path + ".missing"));
+}
+
+TEST(static_parameters, options_and_commands)
+{
+    int value_int = 0;
+    std::string value_string = "";
+    std::optional<int> value_int_opt;
+    bool flag = false;
+    std::optional<bool> flag_opt;
+    int triggered_command = 0;
+
+    auto params
+        = cli::static_option<int>{ value_int, "value_int", "Opt testning 1" }
+        | cli::static_option<std::string>{ value_string, "value_string" }
+        | cli::static_option<std::optional<int>>{ value_int_opt, "-i|--int" }
+        | cli::static_option_flag<bool>{ flag, "-f|--flag" }
+        | cli::static_option_flag<std::optional<bool>>{ flag_opt, "--flag_opt" }
+        | cli::static_command{ "yolo|swag", "Testning 1", [&](cli::context&) { triggered_command = 1; return 100; } }
+        | cli::static_command{ "hello", "Testning 2" };
+
+    using params_type = decltype(params);
+    static_assert(std::tuple_size_v<decltype(params.elements)> == 7, "Expecting 7 static elements.");
+    static_assert(cli::impl::count_static_elements<cli::impl::is_static_required_option,
+        cli::static_option<int>, cli::static_option<std::optional<int>>, cli::static_command<>>() == 1,
+        "Expecting 1 required option.");
+    static_assert(cli::impl::static_names_contain("-f|--flag", "--flag"), "Expecting to find --flag.");
+    static_assert(!cli::impl::static_names_contain("-f|--flag", "-"), "Not expecting to find -.");
+    static_assert(!cli::impl::static_names_contain("-f||--flag", ""), "Not expecting to find empty name.");
+    static_assert(cli::impl::static_first_name("-f|--flag") == "-f", "Expecting -f as first name.");
+
+    const auto reset = [&]() {
+        value_int = 0;
+        value_string.clear();
+        value_int_opt.reset();
+        flag = false;
+        flag_opt.reset();
+        triggered_command = 0;
+    };
+
+    // FAIL
+    reset();
+    {
+        auto context = cli::context{}.set_arg(0, nullptr);
+        EXPECT_EQ(params.parse(context), cli::parse_codes::missing_path);
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::missing_option);
+        EXPECT_EQ(value_int, 123);
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "abc", "foo" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::invalid_option_value);
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123", "foo" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::missing_command);
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123", "foo", "--int" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::missing_option_value);
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123", "foo", "--int", "bar" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::invalid_option_value);
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123", "foo", "unknown" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::unknown_command);
+    }
+
+    // OK
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123", "foo", "-i", "234", "--flag", "--flag_opt", "swag" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), 100);
+        EXPECT_EQ(value_int, 123);
+        EXPECT_STREQ(value_string.c_str(), "foo");
+        ASSERT_TRUE(value_int_opt.has_value());
+        EXPECT_EQ(value_int_opt.value(), 234);
+        EXPECT_TRUE(flag);
+        ASSERT_TRUE(flag_opt.has_value());
+        EXPECT_TRUE(flag_opt.value());
+        EXPECT_EQ(triggered_command, 1);
+        ASSERT_EQ(context.current_path.size(), size_t{ 2 });
+        EXPECT_EQ(context.current_path.back(), "swag");
+    }
+    reset();
+    {
+        auto args = std::array{ "path/to/program", "123", "foo", "hello" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context), cli::parse_codes::successful);
+        EXPECT_EQ(triggered_command, 0);
+    }
+
+    // Help
+    {
+        const auto help_params = params | cli::default_help{};
+        static_assert(std::is_same_v<std::decay_t<decltype(help_params)>, params_type>, "Expecting same type.");
+
+        auto args = std::array{ "path/to/program", "--help" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+
+        auto output = test::output_pipe{};
+        context.output_fd = output.fd();
+        ASSERT_EQ(help_params.parse(context), cli::parse_codes::successful_help);
+
+        std::string expected_help_string =
+            "Usage: program <value_int> <value_string> [options] [command] [command-options]\n\n"
+            "Options:\n"
+            "  value_int         Opt testning 1\n"
+            "  value_string      \n"
+            "  -i|--int          \n"
+            "  -f|--flag         \n"
+            "  --flag_opt        \n\n"
+            "Commands:\n"
+            "  -h|--help         Show command line help.\n"
+            "  yolo|swag         Testning 1\n"
+            "  hello             Testning 2\n";
+
+        EXPECT_STREQ(output.read().c_str(), expected_help_string.c_str());
+        EXPECT_FALSE(context.current_parameter_group.has_value());
+    }
+}
+
+TEST(compiled_parameters, parse)
+{
+    int value_int = 0;
+    std::optional<int> value_int_opt;
+    bool flag = false;
+    int triggered_command = 0;
+
+    const auto compiled
+        = (cli::option<int>{ value_int, { "value_int" } }
+        | cli::option<std::optional<int>>{ value_int_opt, { "-i", "--int" } }
+        | cli::option_flag<bool>{ flag, { "-f", "--flag" } }
+        | cli::command{ { "yolo", "swag" }, "", [&](auto&) { triggered_command = 1; return 100; } }
+        | cli::command{ { "hello" } }).compile();
+
+    ASSERT_EQ(compiled.name_count(), size_t{ 8 });
+    EXPECT_EQ(compiled.name(0), "value_int");
+    EXPECT_EQ(compiled.name(2), "--int");
+    EXPECT_EQ(compiled.name(7), "hello");
+    EXPECT_EQ(compiled.source().commands.size(), size_t{ 2 });
+
+    // FAIL
+    {
+        auto args = std::array{ "path/to/program" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(compiled.parse(context), cli::parse_codes::missing_option);
+    }
+    {
+        auto args = std::array{ "path/to/program", "1", "--int" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(compiled.parse(context), cli::parse_codes::missing_option_value);
+    }
+    {
+        auto args = std::array{ "path/to/program", "1", "--value_int" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(compiled.parse(context), cli::parse_codes::unknown_command);
+    }
+
+    // OK
+    {
+        auto args = std::array{ "path/to/program", "123", "-f", "--int", "234", "swag" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(compiled.parse(context), 100);
+        EXPECT_EQ(value_int, 123);
+        ASSERT_TRUE(value_int_opt.has_value());
+        EXPECT_EQ(value_int_opt.value(), 234);
+        EXPECT_TRUE(flag);
+        EXPECT_EQ(triggered_command, 1);
+        ASSERT_TRUE(context.current_parameter_group.has_value());
+        EXPECT_EQ(&context.current_parameter_group.value().get(), &compiled.source());
+    }
+
+    // Default constructed parameters parse as empty ones.
+    {
+        const auto empty = cli::compiled_parameters{};
+        EXPECT_EQ(empty.name_count(), size_t{ 0 });
+        EXPECT_TRUE(empty.source().commands.empty());
+
+        auto args = std::array{ "path/to/program" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(empty.parse(context), cli::parse_codes::successful);
+
+        auto unknown_args = std::array{ "path/to/program", "-x" };
+        auto unknown_context = cli::context{}.set_arg(static_cast<int>(unknown_args.size()), const_cast<char**>(unknown_args.data()))
+            | cli::error{ [](cli::context&, const cli::parse_error&) {} };
+        EXPECT_EQ(empty.parse(unknown_context), cli::parse_codes::unknown_option);
+    }
+}
+
+TEST(compiled_parameters, memory_resource)
+{
+    auto value_int = 0;
+    auto flag = false;
+    const auto params
+        = cli::option<int>{ value_int, { "value_int" } }
+        | cli::option_flag<bool>{ flag, { "-f", "--flag" } }
+        | cli::command{ { "run" } };
+
+    auto arena = std::pmr::monotonic_buffer_resource{};
+    const auto compiled = params.compile(&arena);
+    ASSERT_EQ(compiled.name_count(), size_t{ 4 });
+    EXPECT_EQ(compiled.name(2), "--flag");
+
+    auto context = cli::context{}
+        | cli::error{ [](cli::context&, const cli::parse_error&) {} };
+    context.set_memory_resource(&arena);
+    for (const auto value : { "1", "2" }) {
+        auto args = std::array{ "path/to/program", value, "-f", "run" };
+        context.reset().set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        ASSERT_EQ(compiled.parse(context), cli::parse_codes::successful);
+        ASSERT_EQ(context.current_path.size(), size_t{ 2 });
+        EXPECT_EQ(context.current_path.back(), "run");
+        EXPECT_EQ(context.arg_index, 4);
+    }
+    EXPECT_EQ(value_int, 2);
+    EXPECT_TRUE(flag);
+
+    // Reset clears the parse state, but keeps handlers and capacity.
+    const auto capacity = context.current_path.capacity();
+    context.reset();
+    EXPECT_EQ(context.argc, 0);
+    EXPECT_EQ(context.arg_index, 0);
+    EXPECT_TRUE(context.first_arg_is_path);
+    EXPECT_TRUE(context.current_path.empty());
+    EXPECT_EQ(context.current_path.capacity(), capacity);
+    EXPECT_FALSE(context.current_parameter_group.has_value());
+    EXPECT_TRUE(context.error_handler.has_value());
+    EXPECT_EQ(context.memory_resource(), &arena);
+
+    // Settings are kept as well.
+    context.first_arg_is_path = false;
+    auto args = std::array{ "3", "-f", "run" };
+    context.reset().set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+    EXPECT_FALSE(context.first_arg_is_path);
+    ASSERT_EQ(compiled.parse(context), cli::parse_codes::successful);
+    EXPECT_EQ(value_int, 3);
+    EXPECT_FALSE(context.first_arg_is_path);
+}
+
+TEST(compiled_parameters, concurrent_parse)
+{
+    auto command_counts = std::array<std::atomic<int>, 3>{};
+
+    auto params = cli::parameters{};
+    for (size_t i = 0; i < command_counts.size(); i++) {
+        params.add_command(cli::command{ { "cmd" + std::to_string(i) }, "", [&command_counts, i](auto&) {
+            return ++command_counts[i];
+        } });
+    }
+    const auto compiled = params.compile();
+
+    constexpr int iterations = 1000;
+    auto threads = std::vector<std::thread>{};
+    for (size_t i = 0; i < 4; i++) {
+        threads.emplace_back([&compiled]() {
+            const auto commands = std::array{ "cmd0", "cmd1", "cmd2" };
+            for (int j = 0; j < iterations; j++) {
+                for (const auto* command : commands) {
+                    auto args = std::array{ "path/to/program", command };
+                    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+                    (void)compiled.parse(context);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& count : command_counts) {
+        EXPECT_EQ(count.load(), iterations * 4);
+    }
+}
+
+TEST(detached_parameters, parse)
+{
+    auto params = cli::detached_parameters{};
+    const auto name = params.add_option<std::string_view>({ "name" });
+    const auto count = params.add_option<std::optional<int>>({ "-c", "--count" });
+    const auto ratio = params.add_option<std::optional<double>>({ "-r" });
+    const auto verbose = params.add_flag({ "-v" });
+    const auto run = params.add_command({ "run" });
+
+    {
+        auto args = std::array{ "path/to/program", "test", "--count", "42", "-v", "run" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        const auto result = params.parse(context);
+        ASSERT_EQ(result.code, cli::parse_codes::successful);
+        EXPECT_EQ(result.get(name), "test");
+        EXPECT_EQ(result.get(count), std::optional<int>{ 42 });
+        EXPECT_EQ(result.get(ratio), std::nullopt);
+        EXPECT_TRUE(result.get(verbose));
+        EXPECT_TRUE(result.has(run));
+        ASSERT_TRUE(result.command().has_value());
+        EXPECT_EQ(result.command()->index, run.index);
+    }
+    {
+        auto args = std::array{ "path/to/program", "other", "-r", "1.5" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        auto result = cli::parse_result{};
+        ASSERT_EQ(params.parse(context, result), cli::parse_codes::successful);
+        EXPECT_EQ(result.get(name), "other");
+        EXPECT_FALSE(result.has(count));
+        EXPECT_EQ(result.get(ratio), std::optional<double>{ 1.5 });
+        EXPECT_FALSE(result.get(verbose));
+        EXPECT_FALSE(result.command().has_value());
+    }
+    {
+        auto args = std::array{ "path/to/program", "test", "--count", "abc" };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+        EXPECT_EQ(params.parse(context).code, cli::parse_codes::invalid_option_value);
+    }
+}
+
+TEST(detached_parameters, parse_batch)
+{
+    auto params = cli::detached_parameters{};
+    const auto value = params.add_option<int>({ "value" });
+    const auto verbose = params.add_flag({ "-v" });
+
+    auto lines = std::array{
+        std::array{ "path/to/program", "1", "-v" },
+        std::array{ "path/to/program", "abc", "-v" },
+        std::array{ "path/to/program", "3", "-x" },
+        std::array{ "path/to/program", "4", "-v" } };
+
+    auto arguments = std::vector<cli::arguments>{};
+    for (auto& line : lines) {
+        arguments.push_back(cli::arguments{ static_cast<int>(line.size()), const_cast<char**>(line.data()) });
+    }
+
+    auto results = std::vector<cli::parse_result>{};
+    params.parse_batch(arguments, results);
+
+    ASSERT_EQ(results.size(), lines.size());
+    EXPECT_EQ(results[0].code, cli::parse_codes::successful);
+    EXPECT_EQ(results[0].get(value), 1);
+    EXPECT_TRUE(results[0].get(verbose));
+    EXPECT_EQ(results[1].code, cli::parse_codes::invalid_option_value);
+    EXPECT_EQ(results[2].code, cli::parse_codes::unknown_option);
+    EXPECT_EQ(results[2].get(value), 3);
+    EXPECT_FALSE(results[2].has(verbose));
+    EXPECT_EQ(results[3].code, cli::parse_codes::successful);
+    EXPECT_EQ(results[3].get(value), 4);
+}
+
+TEST(detached_parameters, concurrent_parse)
+{
+    auto params = cli::detached_parameters{};
+    const auto value = params.add_option<int>({ "value" });
+
+    auto failures = std::atomic<int>{ 0 };
+    auto threads = std::vector<std::thread>{};
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&params, &failures, value, i]() {
+            auto result = cli::parse_result{};
+            for (int j = 0; j < 1000; j++) {
+                const auto expected = std::to_string(i * 1000 + j);
+                auto args = std::array{ "path/to/program", expected.c_str() };
+                auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+                if (params.parse(context, result) != cli::parse_codes::successful || result.get(value) != i * 1000 + j) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST(inplace_function, lifetime)
+{
+    struct counter {
+        int* instances;
+        int* calls;
+
+        counter(int* p_instances, int* p_calls) : instances(p_instances), calls(p_calls) { ++(*instances); }
+        counter(const counter& p_other) : instances(p_other.instances), calls(p_other.calls) { ++(*instances); }
+        ~counter() { --(*instances); }
+
+        int operator()(int p_value) { ++(*calls); return p_value * 2; }
+    };
+
+    int instances = 0;
+    int calls = 0;
+    {
+        using function_type = cli::impl::inplace_function<int(int)>;
+
+        auto empty = function_type{};
+        EXPECT_FALSE(empty);
+
+        int(*null_function)(int) = nullptr;
+        auto null_pointer = function_type{ null_function };
+        EXPECT_FALSE(null_pointer);
+
+        auto function = function_type{ counter{ &instances, &calls } };
+        ASSERT_TRUE(function);
+        EXPECT_EQ(instances, 1);
+        EXPECT_EQ(function(21), 42);
+        EXPECT_EQ(calls, 1);
+
+        auto function_copy = function;
+        EXPECT_EQ(instances, 2);
+        EXPECT_EQ(function_copy(1), 2);
+        EXPECT_EQ(calls, 2);
+
+        auto function_moved = std::move(function);
+        EXPECT_FALSE(function);
+        EXPECT_EQ(instances, 2);
+        EXPECT_EQ(function_moved(2), 4);
+
+        function_copy = nullptr;
+        EXPECT_FALSE(function_copy);
+        EXPECT_EQ(instances, 1);
+
+        function = function_moved;
+        EXPECT_EQ(instances, 2);
+        function = [](int p_value) { return p_value + 1; };
+        EXPECT_EQ(instances, 1);
+        EXPECT_EQ(function(1), 2);
+    }
+    EXPECT_EQ(instances, 0);
+
+    // Public callbacks fit a string and a pointer, larger callables are passed by reference.
+    auto name = std::string{ "build" };
+    auto command_callback = cli::command_callback{ [name, &calls](cli::context&) { ++calls; return static_cast<int>(name.size()); } };
+    auto context = cli::context{};
+    EXPECT_EQ(command_callback(context), 5);
+
+    auto large = [names = std::array<std::string, 4>{ "a", "bb", "ccc", "dddd" }](cli::context&) { return static_cast<int>(names[3].size()); };
+    auto large_callback = cli::command_callback{ std::ref(large) };
+    EXPECT_EQ(large_callback(context), 4);
+}
+
+TEST(default_error, empty_callback)
+{
+    auto params = cli::parameters{} | cli::command{ { "yolo" } } | cli::error{};
+
+    auto args = std::array{ "path/to/program", "test" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()));
+
+    EXPECT_EQ(params.parse(context), cli::parse_codes::unknown_command);
+}
+
+TEST(default_error, parse_error)
+{
+    auto value = 0;
+    auto params = cli::parameters{} | cli::option<int>{ value, { "value" } };
+
+    auto errors = std::vector<cli::parse_error>{};
+    auto args = std::array{ "path/to/program", "abc" };
+    auto context = cli::context{}
+        .set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()))
+        | cli::error{ [&errors](cli::context&, const cli::parse_error& p_error) { errors.push_back(p_error); } };
+
+    ASSERT_EQ(params.parse(context), cli::parse_codes::invalid_option_value);
+    ASSERT_EQ(errors.size(), size_t{ 1 });
+    EXPECT_EQ(errors[0].code, cli::parse_codes::invalid_option_value);
+    EXPECT_EQ(errors[0].token.data(), args[1]);
+    EXPECT_EQ(errors[0].name, "value");
+    EXPECT_EQ(errors[0].arg_index, 1);
+    EXPECT_EQ(errors[0].message(), "Invalid value 'abc' of option 'value'.");
+
+    auto message = std::string{};
+    auto string_args = std::array{ "path/to/program", "1", "--unknown" };
+    auto string_context = cli::context{}
+        .set_arg(static_cast<int>(string_args.size()), const_cast<char**>(string_args.data()))
+        | cli::error{ [&message](cli::context&, std::string p_message) { message = std::move(p_message); } };
+
+    ASSERT_EQ(params.parse(string_context), cli::parse_codes::unknown_option);
+    EXPECT_EQ(message, "Unknown option '--unknown'.");
+}
+
+TEST(default_error, suggestions)
+{
+    auto reference_distance = [](std::string_view p_lhs, std::string_view p_rhs) {
+        auto row = std::vector<size_t>(p_rhs.size() + 1);
+        for (size_t j = 0; j <= p_rhs.size(); j++) {
+            row[j] = j;
+        }
+        for (size_t i = 1; i <= p_lhs.size(); i++) {
+            auto diagonal = row[0];
+            row[0] = i;
+            for (size_t j = 1; j <= p_rhs.size(); j++) {
+                const auto above = row[j];
+                row[j] = std::min({ row[j] + 1, row[j - 1] + 1, diagonal + (p_lhs[i - 1] == p_rhs[j - 1] ? 0 : 1) });
+                diagonal = above;
+            }
+        }
+        return row.back();
+    };
+
+    const auto words = std::array<std::string_view, 8>{ "", "a", "build", "buidl", "rebuild", "kitten", "sitting", "abcdefghijklmnopqrstuvwxyz" };
+    for (const auto pattern : words) {
+        if (pattern.empty()) {
+            continue;
+        }
+        auto masks = std::array<std::uint64_t, 256>{};
+        for (size_t i = 0; i < pattern.size(); i++) {
+            masks[static_cast<unsigned char>(pattern[i])] |= std::uint64_t{ 1 } << i;
+        }
+        for (const auto text : words) {
+            EXPECT_EQ(cli::impl::edit_distance(masks, pattern.size(), text), reference_distance(pattern, text)) << pattern << " " << text;
+        }
+    }
+
+    auto verbose = false;
+    auto params
+        = cli::parameters{}
+        | cli::option_flag<bool>{ verbose, { "--verbose" } }
+        | cli::command{ { "build" } }
+        | cli::command{ { "rebuild" } }
+        | cli::command{ { "guild" } }
+        | cli::command{ { "clean" } };
+
+    auto errors = std::vector<std::string>{};
+    auto suggestions = std::vector<std::vector<std::string_view>>{};
+    auto handler = cli::error{ [&](cli::context&, const cli::parse_error& p_error) {
+        auto names = std::array<std::string_view, cli::parse_error::max_suggestions>{};
+        suggestions.emplace_back(names.begin(), names.begin() + static_cast<std::ptrdiff_t>(p_error.suggestions(names.data())));
+        errors.push_back(p_error.message());
+    } };
+
+    for (const auto* token : { "uild", "--verbos", "xyz" }) {
+        auto args = std::array{ "path/to/program", token };
+        auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data())) | handler;
+        params.parse(context);
+    }
+
+    ASSERT_EQ(errors.size(), size_t{ 3 });
+    EXPECT_EQ(suggestions[0], (std::vector<std::string_view>{ "build", "guild" }));
+    EXPECT_EQ(errors[0], "Unknown command 'uild'. Did you mean 'build' or 'guild'?");
+    EXPECT_EQ(suggestions[1], (std::vector<std::string_view>{ "--verbose" }));
+    EXPECT_EQ(errors[1], "Unknown command '--verbos'. Did you mean '--verbose'?");
+    EXPECT_TRUE(suggestions[2].empty());
+    EXPECT_EQ(errors[2], "Unknown command 'xyz'.");
+
+    auto static_message = std::string{};
+    const auto static_params = cli::static_option_flag<bool>{ verbose, "-v|--verbose" } | cli::static_command{ "build|make" };
+    auto args = std::array{ "path/to/program", "mak" };
+    auto context = cli::context{}.set_arg(static_cast<int>(args.size()), const_cast<char**>(args.data()))
+        | cli::error{ [&static_message](cli::context&, std::string p_message) { static_message = std::move(p_message); } };
+    static_params.parse(context);
+    EXPECT_EQ(static_message, "Unknown command 'mak'. Did you mean 'make'?");
+}
+
 TEST(default_error, context)
 {
     auto params
@@ -710,11 +2222,9 @@ TEST(default_help, mix_options_and_commands)
         EXPECT_EQ(context.argc, 2);
         EXPECT_EQ(context.argv, args.data());
 
-        std::stringstream cout_stream;
-        {
-            auto cout_redirect = test::output_redirect{ std::cout, cout_stream };
-            ASSERT_EQ(params.parse(context), cli::parse_codes::successful_help);
-        }
+        auto output = test::output_pipe{};
+        context.output_fd = output.fd();
+        ASSERT_EQ(params.parse(context), cli::parse_codes::successful_help);
 
         std::string expected_help_string =
             "Usage: program <value_int> <value_bool> <value_string> [options] [command] [command-options]\n\n"
@@ -733,8 +2243,21 @@ TEST(default_help, mix_options_and_commands)
             "  hello                 Testning 2\n"
             "  foo|bar               Testning 3\n";
 
-        auto help_string = cout_stream.str();
+        auto help_string = output.read();
         EXPECT_STREQ(help_string.c_str(), expected_help_string.c_str());
+        EXPECT_EQ(cli::default_help::default_string(context, params), expected_help_string);
+
+        // Cached body follows schema changes.
+        params.add_command(cli::command{ { "added" }, "Testning 4" });
+        EXPECT_NE(cli::default_help::default_string(context, params).find("  added                 Testning 4\n"), std::string::npos);
+
+        // In place edits are seen once the parameters are rebuilt.
+        params.commands.front().description = "Testning 5";
+        params.commands.back().names.push_back("baz");
+        params.rebuild_index();
+        const auto edited_help_string = cli::default_help::default_string(context, params);
+        EXPECT_NE(edited_help_string.find("  yolo|swag             Testning 5\n"), std::string::npos);
+        EXPECT_NE(edited_help_string.find("  added|baz             Testning 4\n"), std::string::npos);
     }
 
 }
\ No newline at end of file
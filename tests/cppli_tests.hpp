@@ -29,8 +29,18 @@
 #include "gtest/gtest.h"
 #include "cppli/cppli.hpp"
 #include <array>
+#include <atomic>
+#include <thread>
 #include <streambuf>
 #include <sstream>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace test {
 
@@ -81,6 +91,62 @@ namespace test {
 
     };
 
+    class output_pipe {
+    private:
+
+        std::array<int, 2> m_fds = { -1, -1 };
+
+#if defined(_WIN32)
+        static int open_pipe(int* p_fds) { return ::_pipe(p_fds, 65536, _O_BINARY); }
+        static int read_fd(int p_fd, char* p_buffer, std::size_t p_size) { return ::_read(p_fd, p_buffer, static_cast<unsigned int>(p_size)); }
+        static void close_fd(int p_fd) { ::_close(p_fd); }
+#else
+        static int open_pipe(int* p_fds) { return ::pipe(p_fds); }
+        static int read_fd(int p_fd, char* p_buffer, std::size_t p_size) { return static_cast<int>(::read(p_fd, p_buffer, p_size)); }
+        static void close_fd(int p_fd) { ::close(p_fd); }
+#endif
+
+    public:
+        [[nodiscard]] output_pipe() {
+            if (open_pipe(m_fds.data()) != 0) {
+                m_fds = { -1, -1 };
+            }
+        }
+
+        ~output_pipe() {
+            for (const auto fd : m_fds) {
+                if (fd >= 0) {
+                    close_fd(fd);
+                }
+            }
+        }
+
+        int fd() const {
+            return m_fds[1];
+        }
+
+        std::string read() {
+            if (m_fds[1] >= 0) {
+                close_fd(m_fds[1]);
+                m_fds[1] = -1;
+            }
+
+            auto result = std::string{};
+            auto buffer = std::array<char, 256>{};
+            int size = 0;
+            while (m_fds[0] >= 0 && (size = read_fd(m_fds[0], buffer.data(), buffer.size())) > 0) {
+                result.append(buffer.data(), static_cast<std::size_t>(size));
+            }
+            return result;
+        }
+
+        output_pipe(const output_pipe&) = delete;
+        output_pipe(output_pipe&&) = delete;
+        output_pipe& operator = (const output_pipe&) = delete;
+        output_pipe& operator = (output_pipe&&) = delete;
+
+    };
+
 }
 
 #endif
\ No newline at end of file